@@ -0,0 +1,58 @@
+#include "barrett.h"
+#include "digit_kernels.h"
+#include <stdexcept>
+
+barrett_context::barrett_context(big_integer const &modulus) {
+    if (modulus <= 1) {
+        throw std::runtime_error("Barrett modulus must be greater than one");
+    }
+    mod = modulus;
+    mod_digits = big_integer_limbs::digits(modulus);
+    while (mod_digits.back() == 0) {
+        mod_digits.pop_back();
+    }
+    mu = big_integer_limbs::digits((big_integer(1) << static_cast<int>(64 * size())) / modulus);
+    mu.resize(size() + 2);
+    unit = to_residue(1);
+}
+
+barrett_context::residue barrett_context::to_residue(big_integer const &value) const {
+    return reduced_digits(value);
+}
+
+big_integer barrett_context::from_residue(residue const &value) const {
+    return big_integer_limbs::from_digits(value);
+}
+
+// Classical Barrett reduction of the 2n-digit product x with
+// mu = floor(b^2n / m): q = floor(floor(x / b^(n-1)) * mu / b^(n+1)) is at
+// most two below floor(x / m), so x - q * m, computed modulo b^(n+1), needs
+// at most two final subtractions. Only the high digits of the quotient
+// product and the low digits of q * m are formed.
+void barrett_context::multiply(residue &result, residue const &first, residue const &second,
+                               residue &scratch) const {
+    size_t n = size();
+    scratch.resize(4 * n + 4);
+    uint32_t *x = scratch.data();
+    uint32_t *q = x + 2 * n;
+    uint32_t *r = q + n + 2;
+    mul_low_digits(x, first.data(), n, second.data(), n, 2 * n);
+    mul_high_digits(q, x + n - 1, n + 1, mu.data(), n + 2, n + 1);
+    mul_low_digits(r, q, n + 2, mod_digits.data(), n, n + 1);
+    uint64_t borrow = 0;
+    for (size_t i = 0; i <= n; i++) {
+        uint64_t diff = static_cast<uint64_t>(x[i]) - r[i] - borrow;
+        r[i] = static_cast<uint32_t>(diff);
+        borrow = diff >> 63u;
+    }
+    while (!less_than_modulus(r, r[n])) {
+        borrow = 0;
+        for (size_t i = 0; i <= n; i++) {
+            uint64_t diff = static_cast<uint64_t>(r[i]) - (i < n ? mod_digits[i] : 0) - borrow;
+            r[i] = static_cast<uint32_t>(diff);
+            borrow = diff >> 63u;
+        }
+    }
+    result.assign(r, r + n);
+}
+
@@ -0,0 +1,20 @@
+#ifndef BARRETT_H
+#define BARRETT_H
+
+#include "residue_context.h"
+
+class barrett_context : public residue_context<barrett_context> {
+public:
+    explicit barrett_context(big_integer const &modulus);
+
+    residue to_residue(big_integer const &value) const;
+
+    big_integer from_residue(residue const &value) const;
+
+    void multiply(residue &result, residue const &first, residue const &second, residue &scratch) const;
+
+private:
+    std::vector<uint32_t> mu;
+};
+
+#endif
@@ -0,0 +1,253 @@
+#include "big_float.h"
+#include <algorithm>
+#include <stdexcept>
+
+big_float::big_float(size_t precision) : mant(0), exp(0), prec(precision) {
+    if (precision == 0) {
+        throw std::runtime_error("Precision must be positive");
+    }
+}
+
+big_float::big_float(big_integer const &value, size_t precision) : big_float(value, 0, precision) {
+}
+
+big_float::big_float(big_integer const &mantissa, int64_t exponent, size_t precision)
+        : mant(mantissa), exp(exponent), prec(precision) {
+    if (precision == 0) {
+        throw std::runtime_error("Precision must be positive");
+    }
+    round();
+}
+
+big_integer const &big_float::mantissa() const {
+    return mant;
+}
+
+int64_t big_float::exponent() const {
+    return exp;
+}
+
+size_t big_float::precision() const {
+    return prec;
+}
+
+big_float big_float::with_precision(size_t precision) const {
+    return big_float(mant, exp, precision);
+}
+
+void big_float::round() {
+    if (mant == 0) {
+        exp = 0;
+        return;
+    }
+    bool negative = mant < 0;
+    big_integer magnitude = negative ? -mant : mant;
+    size_t length = magnitude.bit_length();
+    if (length > prec) {
+        int shift = static_cast<int>(length - prec);
+        big_integer kept = magnitude >> shift;
+        big_integer rest = magnitude - (kept << shift);
+        big_integer half = big_integer(1) << (shift - 1);
+        if (rest > half || (rest == half && (kept.to_uint64() & 1u))) {
+            kept += 1;
+        }
+        magnitude = kept;
+        exp += shift;
+    }
+    size_t zeros = magnitude.trailing_zeros();
+    magnitude >>= static_cast<int>(zeros);
+    exp += static_cast<int64_t>(zeros);
+    mant = negative ? -magnitude : magnitude;
+}
+
+int64_t big_float::top() const {
+    return exp + static_cast<int64_t>((mant < 0 ? -mant : mant).bit_length());
+}
+
+big_integer big_float::to_big_integer() const {
+    if (exp >= 0) {
+        return mant << static_cast<int>(exp);
+    }
+    if (top() <= 0) {
+        return 0;
+    }
+    big_integer magnitude = (mant < 0 ? -mant : mant) >> static_cast<int>(-exp);
+    return mant < 0 ? -magnitude : magnitude;
+}
+
+int big_float::compare(big_float const &second) const {
+    int first_sign = mant == 0 ? 0 : mant < 0 ? -1 : 1;
+    int second_sign = second.mant == 0 ? 0 : second.mant < 0 ? -1 : 1;
+    if (first_sign != second_sign) {
+        return first_sign < second_sign ? -1 : 1;
+    }
+    if (first_sign == 0) {
+        return 0;
+    }
+    if (top() != second.top()) {
+        return (top() > second.top()) == (first_sign > 0) ? 1 : -1;
+    }
+    int64_t e = std::min(exp, second.exp);
+    big_integer x = mant << static_cast<int>(exp - e);
+    big_integer y = second.mant << static_cast<int>(second.exp - e);
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+bool operator==(big_float const &first, big_float const &second) {
+    return first.compare(second) == 0;
+}
+
+bool operator!=(big_float const &first, big_float const &second) {
+    return first.compare(second) != 0;
+}
+
+bool operator<(big_float const &first, big_float const &second) {
+    return first.compare(second) < 0;
+}
+
+bool operator<=(big_float const &first, big_float const &second) {
+    return first.compare(second) <= 0;
+}
+
+bool operator>(big_float const &first, big_float const &second) {
+    return first.compare(second) > 0;
+}
+
+bool operator>=(big_float const &first, big_float const &second) {
+    return first.compare(second) >= 0;
+}
+
+big_float big_float::operator-() const {
+    big_float result = *this;
+    result.mant = -mant;
+    return result;
+}
+
+// An operand lying entirely below the rounding position of the other one
+// only decides the sticky bit, so it is replaced by a single bit of the same
+// sign just below the guard bits and the alignment shift stays bounded by
+// the precision.
+big_float operator+(big_float const &first, big_float const &second) {
+    size_t precision = std::max(first.prec, second.prec);
+    if (first.mant == 0) {
+        return second.with_precision(precision);
+    }
+    if (second.mant == 0) {
+        return first.with_precision(precision);
+    }
+    big_float const &large = first.top() >= second.top() ? first : second;
+    big_float const &small = first.top() >= second.top() ? second : first;
+    big_integer small_mant = small.mant;
+    int64_t small_exp = small.exp;
+    int64_t limit = large.top() - static_cast<int64_t>(precision) - 3;
+    if (small.top() < limit) {
+        small_mant = small.mant < 0 ? -1 : 1;
+        small_exp = limit - 1;
+    }
+    int64_t e = std::min(large.exp, small_exp);
+    big_float result(precision);
+    result.mant = (large.mant << static_cast<int>(large.exp - e)) + (small_mant << static_cast<int>(small_exp - e));
+    result.exp = e;
+    result.round();
+    return result;
+}
+
+big_float operator-(big_float const &first, big_float const &second) {
+    return first + -second;
+}
+
+// Mantissas are odd, so their product is odd and any dropped low digits are
+// non-zero: the high product keeps at least precision + 2 bits and one more
+// sticky bit is all that correct rounding needs from the discarded part.
+big_float operator*(big_float const &first, big_float const &second) {
+    size_t precision = std::max(first.prec, second.prec);
+    big_float result(precision);
+    if (first.mant == 0 || second.mant == 0) {
+        return result;
+    }
+    big_integer x = first.mant < 0 ? -first.mant : first.mant;
+    big_integer y = second.mant < 0 ? -second.mant : second.mant;
+    int64_t excess = static_cast<int64_t>(x.bit_length() + y.bit_length()) -
+                     static_cast<int64_t>(precision + 3);
+    size_t skip = excess > 0 ? static_cast<size_t>(excess) / 32 : 0;
+    result.mant = mul_high(x, y, skip);
+    result.exp = first.exp + second.exp + 32 * static_cast<int64_t>(skip);
+    if (skip != 0) {
+        result.mant = (result.mant << 1) + 1;
+        result.exp -= 1;
+    }
+    if ((first.mant < 0) != (second.mant < 0)) {
+        result.mant = -result.mant;
+    }
+    result.round();
+    return result;
+}
+
+// The quotient is computed to at least precision + 2 bits and one more bit
+// records whether the remainder was non-zero, which is all that correct
+// rounding needs.
+big_float operator/(big_float const &first, big_float const &second) {
+    if (second.mant == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    size_t precision = std::max(first.prec, second.prec);
+    big_float result(precision);
+    if (first.mant == 0) {
+        return result;
+    }
+    big_integer numerator = first.mant < 0 ? -first.mant : first.mant;
+    big_integer denominator = second.mant < 0 ? -second.mant : second.mant;
+    int64_t shift = static_cast<int64_t>(precision + 2 + denominator.bit_length()) -
+                    static_cast<int64_t>(numerator.bit_length());
+    shift = std::max<int64_t>(shift, 0);
+    numerator <<= static_cast<int>(shift);
+    big_integer quotient = numerator / denominator;
+    bool inexact = numerator != quotient * denominator;
+    result.mant = (quotient << 1) + (inexact ? 1 : 0);
+    if ((first.mant < 0) != (second.mant < 0)) {
+        result.mant = -result.mant;
+    }
+    result.exp = first.exp - second.exp - shift - 1;
+    result.round();
+    return result;
+}
+
+big_float &big_float::operator+=(big_float const &second) {
+    return *this = *this + second;
+}
+
+big_float &big_float::operator-=(big_float const &second) {
+    return *this = *this - second;
+}
+
+big_float &big_float::operator*=(big_float const &second) {
+    return *this = *this * second;
+}
+
+big_float &big_float::operator/=(big_float const &second) {
+    return *this = *this / second;
+}
+
+big_float sqrt(big_float const &value) {
+    if (value.mant < 0) {
+        throw std::runtime_error("Square root of negative number");
+    }
+    big_float result(value.prec);
+    if (value.mant == 0) {
+        return result;
+    }
+    big_integer m = value.mant;
+    int64_t e = value.exp;
+    if (e % 2 != 0) {
+        m <<= 1;
+        e -= 1;
+    }
+    int64_t shift = 2 * static_cast<int64_t>(value.prec + 2) - static_cast<int64_t>(m.bit_length());
+    shift = std::max<int64_t>(shift, 0);
+    shift += shift % 2;
+    std::pair<big_integer, big_integer> root = sqrtrem(m << static_cast<int>(shift));
+    result.mant = (root.first << 1) + (root.second != 0 ? 1 : 0);
+    result.exp = (e - shift) / 2 - 1;
+    result.round();
+    return result;
+}
@@ -0,0 +1,74 @@
+#ifndef BIG_FLOAT_H
+#define BIG_FLOAT_H
+
+#include "big_integer.h"
+#include <cstdint>
+
+// A binary floating-point value mantissa * 2^exponent whose mantissa is kept
+// rounded to at most precision bits (round to nearest, ties to even) with no
+// trailing zero bits.
+class big_float {
+public:
+    explicit big_float(size_t precision = 64);
+
+    big_float(big_integer const &value, size_t precision);
+
+    big_float(big_integer const &mantissa, int64_t exponent, size_t precision);
+
+    big_integer const &mantissa() const;
+
+    int64_t exponent() const;
+
+    size_t precision() const;
+
+    big_float with_precision(size_t precision) const;
+
+    big_integer to_big_integer() const;
+
+    friend bool operator==(big_float const &first, big_float const &second);
+
+    friend bool operator!=(big_float const &first, big_float const &second);
+
+    friend bool operator<(big_float const &first, big_float const &second);
+
+    friend bool operator<=(big_float const &first, big_float const &second);
+
+    friend bool operator>(big_float const &first, big_float const &second);
+
+    friend bool operator>=(big_float const &first, big_float const &second);
+
+    big_float operator-() const;
+
+    friend big_float operator+(big_float const &first, big_float const &second);
+
+    friend big_float operator-(big_float const &first, big_float const &second);
+
+    friend big_float operator*(big_float const &first, big_float const &second);
+
+    friend big_float operator/(big_float const &first, big_float const &second);
+
+    big_float &operator+=(big_float const &second);
+
+    big_float &operator-=(big_float const &second);
+
+    big_float &operator*=(big_float const &second);
+
+    big_float &operator/=(big_float const &second);
+
+    friend big_float sqrt(big_float const &value);
+
+private:
+    big_integer mant;
+    int64_t exp;
+    size_t prec;
+
+    void round();
+
+    int64_t top() const;
+
+    int compare(big_float const &second) const;
+};
+
+big_float sqrt(big_float const &value);
+
+#endif
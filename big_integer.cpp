@@ -1,7 +1,11 @@
 #include "big_integer.h"
+#include "big_integer_limbs.h"
+#include "digit_kernels.h"
+#include "parallel.h"
 #include <algorithm>
 #include <stdexcept>
 #include <cstring>
+#include <cmath>
 
 big_integer::big_integer() noexcept : big_integer(0) {}
 
@@ -122,6 +126,7 @@ std::string to_string(big_integer const &big_int) {
     } else {
         copy = big_int;
     }
+    copy.make_unique();
     std::string result;
     do {
         auto tmp = copy.divide_by_short_with_remainder(1000000000);
@@ -207,6 +212,7 @@ big_integer &big_integer::operator<<=(int second) {
     make_unique();
     auto delta_full = static_cast<size_t>(second / 32);
     auto delta_local = static_cast<size_t>(second % 32);
+    uint32_t fill = sign() ? 0xFFFFFFFF : 0;
     vector_resize(size() + delta_full);
     for (size_t i = size(); i-- > delta_full;) {
         uint32_t digit = 0;
@@ -219,35 +225,79 @@ big_integer &big_integer::operator<<=(int second) {
     for (size_t i = 0; i < delta_full; i++) {
         set_digit(i, 0);
     }
+    if (get_digit(size() - 1) != fill) {
+        push_back(fill);
+    }
     normalize();
     return *this;
 }
 
 
 void big_integer::multiply_by_big(big_integer const &second) {
-    std::vector<uint32_t> result(size() + second.size());
-    uint64_t carry = 0;
-    for (size_t i = 0; i < size(); i++) {
-        carry = 0;
-        for (size_t j = 0; j < second.size(); j++) {
-            carry += result[i + j] + get_digit(i) * static_cast<uint64_t>(second.get_digit(j));
+    std::vector<uint32_t> a = digits();
+    std::vector<uint32_t> b = second.digits();
+    std::vector<uint32_t> result(a.size() + b.size() + 1);
+    mul_digits(result.data(), a.data(), a.size(), b.data(), b.size());
+    small_size = 3;
+    number = std::make_shared<std::vector<uint32_t>>(std::move(result));
+    normalize();
+}
+
+// Each cross product d[i] * d[j], i < j, is computed once and doubled, and
+// the diagonal squares are added afterwards; long squares go to Karatsuba.
+void big_integer::square() {
+    std::vector<uint32_t> d = digits();
+    size_t n = d.size();
+    std::vector<uint32_t> result(2 * n + 1);
+    if (n >= KARATSUBA_THRESHOLD) {
+        mul_digits(result.data(), d.data(), n, d.data(), n);
+        small_size = 3;
+        number = std::make_shared<std::vector<uint32_t>>(std::move(result));
+        normalize();
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint64_t carry = 0;
+        for (size_t j = i + 1; j < n; j++) {
+            carry += result[i + j] + d[i] * static_cast<uint64_t>(d[j]);
             result[i + j] = static_cast<uint32_t>(carry);
-            carry >>= 32;
+            carry >>= 32u;
         }
-        result[i + second.size()] = static_cast<uint32_t>(carry);
+        result[i + n] = static_cast<uint32_t>(carry);
+    }
+    uint32_t shifted = 0;
+    for (size_t i = 0; i < 2 * n; i++) {
+        uint32_t next = result[i] >> 31u;
+        result[i] = (result[i] << 1u) | shifted;
+        shifted = next;
+    }
+    uint64_t carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        uint64_t product = d[i] * static_cast<uint64_t>(d[i]);
+        carry += result[2 * i] + (product & 0xFFFFFFFFu);
+        result[2 * i] = static_cast<uint32_t>(carry);
+        carry >>= 32u;
+        carry += result[2 * i + 1] + (product >> 32u);
+        result[2 * i + 1] = static_cast<uint32_t>(carry);
+        carry >>= 32u;
     }
     small_size = 3;
-    number = std::make_shared<std::vector<uint32_t>>(result);
+    number = std::make_shared<std::vector<uint32_t>>(std::move(result));
     normalize();
 }
 
 big_integer &big_integer::operator*=(big_integer const &second) {
+    bool is_square = this == &second || (small_size == 3 && second.small_size == 3 && number == second.number);
     make_unique();
     bool result_sign = sign() != second.sign();
     big_integer a;
     if (sign()) {
         negate();
     }
+    if (is_square) {
+        square();
+        return *this;
+    }
     big_integer b;
     if (second.sign()) {
         b = -second;
@@ -270,7 +320,7 @@ void big_integer::divide_by_big(big_integer &dividend) {
         *this = 0;
         return;
     }
-    auto norm = static_cast<uint32_t>((1ull << 32u) / (dividend.get_digit(dividend.size() - 2) + 1));
+    auto norm = static_cast<uint32_t>((1ull << 32u) / (dividend.get_digit(dividend.size() - 2) + 1ull));
     multiply_by_short(norm);
     dividend.make_unique();
     dividend.multiply_by_short(norm);
@@ -286,8 +336,7 @@ void big_integer::divide_by_big(big_integer &dividend) {
         uint64_t r =
                 ((static_cast<uint64_t>(get_digit_with_check(i + N)) << 32u) + get_digit_with_check(i + N - 1)) %
                 dividend.get_digit(N - 1);
-        q = std::min(q, static_cast<uint64_t>(0xFFFFFFFF));
-        while (q == (1ull << 32u) || (q * (dividend.get_digit(N - 2)) > (r << 32u) + get_digit_with_check(i + N - 2))) {
+        while (q >= (1ull << 32u) || (q * (dividend.get_digit(N - 2)) > (r << 32u) + get_digit_with_check(i + N - 2))) {
             q--;
             r += dividend.get_digit(N - 1);
             if (r >= (1ull << 32u)) {
@@ -406,10 +455,10 @@ int big_integer::compare(big_integer const &second) const {
     }
     for (size_t i = size(); i-- > 0;) {
         if (get_digit(i) > second.get_digit(i)) {
-            return return_value;
+            return 1;
         }
         if (get_digit(i) < second.get_digit(i)) {
-            return -return_value;
+            return -1;
         }
     }
     return 0;
@@ -427,7 +476,6 @@ big_integer operator-(big_integer first, const big_integer &second) {
 }
 
 big_integer operator*(big_integer first, const big_integer &second) {
-    first.make_unique();
     return first *= second;
 }
 
@@ -528,16 +576,24 @@ void big_integer::vector_resize(size_t new_size) {
 
 void big_integer::add_or_sub(big_integer const &second, const size_t delta_second, const bool is_sub) {
     auto carry = static_cast<uint64_t>(is_sub);
-    size_t len = std::max(size(), second.size() + delta_second);
-    size_t min_len = std::min(size(), second.size() + delta_second);
+    size_t second_len = second.size() + delta_second;
+    size_t len = std::max(size(), second_len);
+    uint32_t tail = (second.sign() != is_sub) ? 0xFFFFFFFF : 0;
+    uint32_t head = sign() ? 0xFFFFFFFF : 0;
     vector_resize(len);
-    for (size_t i = delta_second; (carry || i < min_len) && i < len; i++) {
-        carry += get_digit_with_check(i) + static_cast<uint64_t>(is_sub ? ~second.get_digit_with_check(i - delta_second)
-                                                                        : second.get_digit_with_check(
-                        i - delta_second));
+    for (size_t i = delta_second; i < len; i++) {
+        if (i >= second_len && (tail == 0) == (carry == 0)) {
+            break;
+        }
+        uint32_t digit = second.get_digit_with_check(i - delta_second);
+        carry += get_digit(i) + static_cast<uint64_t>(is_sub ? ~digit : digit);
         set_digit(i, static_cast<uint32_t>(carry));
         carry >>= 32u;
     }
+    auto extension = static_cast<uint32_t>(head + tail + carry);
+    if (get_digit(len - 1) != extension) {
+        push_back(extension);
+    }
     normalize();
 }
 
@@ -607,3 +663,581 @@ void big_integer::set_digit(size_t pos, uint32_t value) {
 
 
 
+
+
+size_t big_integer::bit_length() const {
+    if (size() == 1) {
+        return 0;
+    }
+    uint32_t top = get_digit(size() - 2);
+    size_t result = (size() - 2) * 32;
+    while (top != 0) {
+        result++;
+        top >>= 1u;
+    }
+    return result;
+}
+
+size_t big_integer::trailing_zeros() const {
+    if (size() == 1 && get_digit(0) == 0) {
+        return 0;
+    }
+    size_t i = 0;
+    while (get_digit(i) == 0) {
+        i++;
+    }
+    size_t result = i * 32;
+    for (uint32_t digit = get_digit(i); (digit & 1u) == 0; digit >>= 1u) {
+        result++;
+    }
+    return result;
+}
+
+uint64_t big_integer::to_uint64() const {
+    return (static_cast<uint64_t>(get_digit_with_check(1)) << 32u) | get_digit(0);
+}
+
+big_integer big_integer::from_uint64(uint64_t value) {
+    big_integer result;
+    result.small[0] = static_cast<uint32_t>(value);
+    result.small[1] = static_cast<uint32_t>(value >> 32u);
+    result.small_size = 2;
+    result.push_back(0);
+    result.normalize();
+    return result;
+}
+
+std::vector<uint32_t> big_integer::digits() const {
+    std::vector<uint32_t> result(size() - 1);
+    for (size_t i = 0; i < result.size(); i++) {
+        result[i] = get_digit(i);
+    }
+    return result;
+}
+
+big_integer big_integer::from_digits(std::vector<uint32_t> digits) {
+    digits.push_back(0);
+    big_integer result;
+    result.small_size = 3;
+    result.number = std::make_shared<std::vector<uint32_t>>(std::move(digits));
+    result.normalize();
+    return result;
+}
+
+namespace {
+    size_t const KARATSUBA_SQRT_THRESHOLD = 2048;
+
+    struct square_residues {
+        bool mod64[64] = {};
+        bool mod63[63] = {};
+        bool mod65[65] = {};
+        bool mod11[11] = {};
+
+        square_residues() {
+            for (uint32_t i = 0; i < 65; i++) {
+                mod64[i * i % 64] = true;
+                mod63[i * i % 63] = true;
+                mod65[i * i % 65] = true;
+                mod11[i * i % 11] = true;
+            }
+        }
+    };
+
+    square_residues const SQUARE_RESIDUES;
+
+    word_divisor const SQUARE_RESIDUE_DIVISOR(63 * 65 * 11);
+
+    bool is_small_prime(uint32_t value) {
+        if (value < 2) {
+            return false;
+        }
+        for (uint32_t d = 2; d * d <= value; d++) {
+            if (value % d == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint32_t power_mod(uint64_t base, uint32_t exp, uint32_t mod) {
+        uint64_t result = 1;
+        for (base %= mod; exp > 0; exp >>= 1u) {
+            if (exp & 1u) {
+                result = result * base % mod;
+            }
+            base = base * base % mod;
+        }
+        return static_cast<uint32_t>(result);
+    }
+
+    big_integer power(big_integer base, uint32_t exp) {
+        big_integer result = 1;
+        for (; exp > 0; exp >>= 1u) {
+            if (exp & 1u) {
+                result *= base;
+            }
+            if (exp > 1) {
+                base *= base;
+            }
+        }
+        return result;
+    }
+
+    // Precision-doubling Newton iteration: the leading bits of the root are
+    // refined in 64-bit arithmetic from the top limbs, then every further step
+    // doubles the number of correct bits with one division.
+    big_integer sqrt_newton(big_integer const &n) {
+        size_t length = n.bit_length();
+        size_t c = (length - 1) / 2;
+        size_t shift = length > 64 ? length - 64 : 0;
+        uint64_t top = (n >> static_cast<int>(shift)).to_uint64();
+        size_t s = 0;
+        while ((c >> s) > 1) {
+            s++;
+        }
+        uint64_t a = 1;
+        size_t d = 0;
+        size_t steps = c == 0 ? 0 : s + 1;
+        for (; steps > 0 && (c >> (steps - 1)) <= 31; steps--) {
+            size_t e = d;
+            d = c >> (steps - 1);
+            a = (a << (d - e - 1)) + (top >> (2 * c - e - d + 1 - shift)) / a;
+        }
+        big_integer result = big_integer::from_uint64(a);
+        for (; steps > 0; steps--) {
+            size_t e = d;
+            d = c >> (steps - 1);
+            result = (result << static_cast<int>(d - e - 1)) + (n >> static_cast<int>(2 * c - e - d + 1)) / result;
+        }
+        if (result * result > n) {
+            result -= 1;
+        }
+        return result;
+    }
+
+    // Zimmermann's Karatsuba square root: the root of the upper half is computed
+    // recursively and extended by one half-size division and one squaring.
+    std::pair<big_integer, big_integer> sqrtrem_karatsuba(big_integer const &n) {
+        size_t length = n.bit_length();
+        if (length <= KARATSUBA_SQRT_THRESHOLD) {
+            big_integer root = length == 0 ? big_integer(0) : sqrt_newton(n);
+            return {root, n - root * root};
+        }
+        size_t h = ((length + 3) / 4 + 31) / 32 * 32;
+        size_t norm = (4 * h - length) & ~static_cast<size_t>(1);
+        big_integer m = n << static_cast<int>(norm);
+        big_integer mask = (big_integer(1) << static_cast<int>(h)) - 1;
+        big_integer low = m & mask;
+        big_integer middle = (m >> static_cast<int>(h)) & mask;
+        auto high = sqrtrem_karatsuba(m >> static_cast<int>(2 * h));
+        big_integer divisor = high.first << 1;
+        big_integer dividend = (high.second << static_cast<int>(h)) + middle;
+        big_integer q = dividend / divisor;
+        big_integer root = (high.first << static_cast<int>(h)) + q;
+        big_integer rem = ((dividend - q * divisor) << static_cast<int>(h)) + low - q * q;
+        if (rem < 0) {
+            rem += (root << 1) - 1;
+            root -= 1;
+        }
+        if (norm > 0) {
+            root >>= static_cast<int>(norm / 2);
+            rem = n - root * root;
+        }
+        return {root, rem};
+    }
+}
+
+big_integer isqrt(big_integer const &n) {
+    if (n < 0) {
+        throw std::runtime_error("Square root of negative number");
+    }
+    if (n.bit_length() <= KARATSUBA_SQRT_THRESHOLD) {
+        return n.bit_length() == 0 ? big_integer(0) : sqrt_newton(n);
+    }
+    return sqrtrem_karatsuba(n).first;
+}
+
+std::pair<big_integer, big_integer> sqrtrem(big_integer const &n) {
+    if (n < 0) {
+        throw std::runtime_error("Square root of negative number");
+    }
+    return sqrtrem_karatsuba(n);
+}
+
+namespace {
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    uint64_t multiply_mod(uint64_t first, uint64_t second, word_divisor const &divisor) {
+        uint128_t product = static_cast<uint128_t>(first) * second;
+        return divisor.remainder(static_cast<uint64_t>(product >> 64u), static_cast<uint64_t>(product));
+    }
+}
+
+word_divisor::word_divisor(uint64_t divisor) : divisor(divisor), normalized(divisor), inverse(0), shift(0) {
+    if (divisor == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    while (normalized >> 63u == 0) {
+        normalized <<= 1u;
+        shift++;
+    }
+    inverse = static_cast<uint64_t>(~static_cast<uint128_t>(0) / normalized);
+}
+
+uint64_t word_divisor::value() const {
+    return divisor;
+}
+
+// The quotient estimate q1 + 1 from the top of inverse * high + (high, low)
+// is at most one too large or too small, so the remainder needs at most one
+// correction in each direction.
+uint64_t word_divisor::remainder(uint64_t high, uint64_t low) const {
+    if (shift != 0) {
+        high = (high << shift) | (low >> (64 - shift));
+        low <<= shift;
+    }
+    uint128_t q = static_cast<uint128_t>(inverse) * high + ((static_cast<uint128_t>(high) << 64u) | low);
+    uint64_t r = low - (static_cast<uint64_t>(q >> 64u) + 1) * normalized;
+    if (r > static_cast<uint64_t>(q)) {
+        r += normalized;
+    }
+    if (r >= normalized) {
+        r -= normalized;
+    }
+    return r >> shift;
+}
+
+// The digits are read as the unsigned number U of size() limbs, two at a
+// time from the top; a negative value equals U - 2^(32 * size()), and the
+// second term comes from square-and-multiply on 2^32 mod d.
+uint64_t big_integer::mod_u64(word_divisor const &divisor) const {
+    size_t n = size();
+    uint64_t result = 0;
+    for (size_t i = (n + 1) / 2; i-- > 0;) {
+        uint64_t high = 2 * i + 1 < n ? get_digit(2 * i + 1) : 0;
+        result = divisor.remainder(result, (high << 32u) | get_digit(2 * i));
+    }
+    if (sign()) {
+        uint64_t wrap = divisor.remainder(0, 1);
+        uint64_t base = divisor.remainder(0, uint64_t(1) << 32u);
+        for (size_t e = n; e != 0; e >>= 1u) {
+            if (e & 1u) {
+                wrap = multiply_mod(wrap, base, divisor);
+            }
+            base = multiply_mod(base, base, divisor);
+        }
+        result = result >= wrap ? result - wrap : result + (divisor.value() - wrap);
+    }
+    return result;
+}
+
+uint64_t big_integer::mod_u64(uint64_t divisor) const {
+    return mod_u64(word_divisor(divisor));
+}
+
+uint32_t big_integer::mod_u32(uint32_t divisor) const {
+    return static_cast<uint32_t>(mod_u64(word_divisor(divisor)));
+}
+
+bool big_integer::divisible_by(uint64_t divisor) const {
+    return mod_u64(word_divisor(divisor)) == 0;
+}
+
+bool big_integer::divisible_by(word_divisor const &divisor) const {
+    return mod_u64(divisor) == 0;
+}
+
+namespace {
+    // The root of the number truncated to its upper half is computed first and
+    // then refined by Newton steps from above, so the precision doubles at every
+    // level; the innermost estimate comes from the leading limbs in floating point.
+    big_integer root_newton(big_integer const &n, uint32_t k) {
+        size_t length = n.bit_length();
+        size_t root_bits = (length + k - 1) / k;
+        big_integer x;
+        if (root_bits <= 32) {
+            size_t shift = length > 64 ? length - 64 : 0;
+            double top = static_cast<double>((n >> static_cast<int>(shift)).to_uint64());
+            double estimate = std::exp2((std::log2(top) + static_cast<double>(shift)) / k);
+            x = big_integer::from_uint64(estimate < 4294967295.0 ? static_cast<uint64_t>(estimate) : 0xFFFFFFFFull);
+            while (power(x, k) > n) {
+                x -= 1;
+            }
+            while (power(x + 1, k) <= n) {
+                x += 1;
+            }
+            return x;
+        }
+        size_t half = root_bits / 2;
+        x = (root_newton(n >> static_cast<int>(half * k), k) + 1) << static_cast<int>(half);
+        while (true) {
+            big_integer y = (x * static_cast<int>(k - 1) + n / power(x, k - 1)) / static_cast<int>(k);
+            if (y >= x) {
+                return x;
+            }
+            x = y;
+        }
+    }
+}
+
+big_integer root(big_integer const &n, uint32_t k) {
+    if (k == 0) {
+        throw std::runtime_error("Zero root");
+    }
+    if (n < 0 && k % 2 == 0) {
+        throw std::runtime_error("Even root of negative number");
+    }
+    if (k == 1 || n.bit_length() <= 1) {
+        return n;
+    }
+    if (n < 0) {
+        return -root_newton(-n, k);
+    }
+    return root_newton(n, k);
+}
+
+std::pair<big_integer, big_integer> rootrem(big_integer const &n, uint32_t k) {
+    big_integer result = root(n, k);
+    return {result, n - power(result, k)};
+}
+
+// Squares are rejected by their residues modulo 64 (low limb) and modulo
+// 63, 65 and 11 (one pass over the limbs modulo 45045) before the root.
+bool is_perfect_square(big_integer const &n) {
+    if (n < 0 || !SQUARE_RESIDUES.mod64[n.to_uint64() & 63u]) {
+        return false;
+    }
+    uint64_t r = n.mod_u64(SQUARE_RESIDUE_DIVISOR);
+    if (!SQUARE_RESIDUES.mod63[r % 63] || !SQUARE_RESIDUES.mod65[r % 65] || !SQUARE_RESIDUES.mod11[r % 11]) {
+        return false;
+    }
+    return sqrtrem(n).second == 0;
+}
+
+bool is_perfect_power(big_integer const &n) {
+    big_integer value = n < 0 ? -n : n;
+    size_t length = value.bit_length();
+    if (length <= 1) {
+        return true;
+    }
+    size_t zeros = value.trailing_zeros();
+    for (uint32_t k = n < 0 ? 3 : 2; k < length; k++) {
+        if (!is_small_prime(k) || zeros % k != 0) {
+            continue;
+        }
+        if (k == 2) {
+            if (is_perfect_square(value)) {
+                return true;
+            }
+            continue;
+        }
+        bool residue = true;
+        uint32_t checked = 0;
+        for (uint32_t p = 2 * k + 1; residue && checked < 4; p += 2 * k) {
+            if (is_small_prime(p)) {
+                uint32_t r = value.mod_u32(p);
+                residue = r == 0 || power_mod(r, (p - 1) / k, p) == 1;
+                checked++;
+            }
+        }
+        if (residue && power(root_newton(value, k), k) == value) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// (first * second) mod 2^(32 * n), from the sign-extended low n digits of
+// both operands.
+big_integer mul_low(big_integer const &first, big_integer const &second, size_t n) {
+    std::vector<uint32_t> a = big_integer_limbs::digits(first);
+    std::vector<uint32_t> b = big_integer_limbs::digits(second);
+    a.resize(first < 0 ? n : std::min(n, a.size()), UINT32_MAX);
+    b.resize(second < 0 ? n : std::min(n, b.size()), UINT32_MAX);
+    std::vector<uint32_t> result(n);
+    mul_low_digits(result.data(), a.data(), a.size(), b.data(), b.size(), n);
+    return big_integer_limbs::from_digits(std::move(result));
+}
+
+// floor(first * second / 2^(32 * n)) for non-negative operands.
+big_integer mul_high(big_integer const &first, big_integer const &second, size_t n) {
+    if (first < 0 || second < 0) {
+        throw std::runtime_error("Negative operand of high product");
+    }
+    std::vector<uint32_t> a = big_integer_limbs::digits(first);
+    std::vector<uint32_t> b = big_integer_limbs::digits(second);
+    if (n >= a.size() + b.size()) {
+        return 0;
+    }
+    std::vector<uint32_t> result(a.size() + b.size() - n);
+    mul_high_digits(result.data(), a.data(), a.size(), b.data(), b.size(), n);
+    return big_integer_limbs::from_digits(std::move(result));
+}
+
+// first / second when second is known to divide first; the result is
+// unspecified otherwise. Powers of two are shifted out so that the divisor is
+// odd and invertible modulo 2^32.
+big_integer divexact(big_integer const &first, big_integer const &second) {
+    if (second == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    if (first == 0) {
+        return 0;
+    }
+    big_integer a = first < 0 ? -first : first;
+    big_integer b = second < 0 ? -second : second;
+    auto zeros = static_cast<int>(b.trailing_zeros());
+    a >>= zeros;
+    b >>= zeros;
+    std::vector<uint32_t> a_digits = big_integer_limbs::digits(a);
+    std::vector<uint32_t> b_digits = big_integer_limbs::digits(b);
+    if (a_digits.size() < b_digits.size()) {
+        return 0;
+    }
+    std::vector<uint32_t> result(a_digits.size() - b_digits.size() + 1);
+    divexact_digits(result.data(), a_digits.data(), a_digits.size(), b_digits.data(), b_digits.size());
+    big_integer quotient = big_integer_limbs::from_digits(std::move(result));
+    return (first < 0) != (second < 0) ? -quotient : quotient;
+}
+
+namespace {
+    size_t const DIVREM_NEWTON_THRESHOLD = 64;
+
+    size_t limb_length(big_integer const &value) {
+        return (value.bit_length() + 31) / 32;
+    }
+
+    // value modulo 2^(32 * n) taken into [-2^(32 * n - 1), 2^(32 * n - 1)),
+    // which recovers value when it is known to lie in that range.
+    big_integer wrap_signed(big_integer const &value, size_t n) {
+        big_integer low = mul_low(value, 1, n);
+        if (low.bit_length() == 32 * n) {
+            low -= big_integer(1) << static_cast<int>(32 * n);
+        }
+        return low;
+    }
+
+    // An approximation of 2^(32 * (k + p)) / d for the k-digit d, a few units
+    // off at most. Only the top p + 2 digits of d matter at that precision;
+    // each Newton step doubles the precision of y ~ 2^(32 * (h + half)) / d
+    // with x = y + y * e / 2^(32 * (h + half)) for e = 2^(32 * (h + half)) - d * y,
+    // where d * y lies just next to a power of two so that its low digits give e.
+    big_integer reciprocal(big_integer const &d, size_t p) {
+        size_t k = limb_length(d);
+        size_t h = std::min(k, p + 2);
+        big_integer top = d >> static_cast<int>(32 * (k - h));
+        if (p <= DIVREM_NEWTON_THRESHOLD / 2) {
+            return (big_integer(1) << static_cast<int>(32 * (h + p))) / top;
+        }
+        size_t half = p / 2 + 1;
+        big_integer y = reciprocal(top, half);
+        big_integer e = -wrap_signed(mul_low(top, y, h + 1), h + 1);
+        size_t shift = h + 2 * half - p;
+        big_integer correction = e < 0 ? -mul_high(y, -e, shift) : mul_high(y, e, shift);
+        return (y << static_cast<int>(32 * (p - half))) + correction;
+    }
+}
+
+// The truncated quotient and remainder of first / second, as / and % give
+// them. Long quotients by long divisors are taken from a Newton reciprocal
+// of the divisor and two short products instead of the schoolbook loop.
+std::pair<big_integer, big_integer> divrem(big_integer const &first, big_integer const &second) {
+    if (second == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    big_integer a = first < 0 ? -first : first;
+    big_integer b = second < 0 ? -second : second;
+    size_t k = limb_length(b);
+    size_t la = limb_length(a);
+    big_integer q;
+    big_integer r;
+    if (la < k + DIVREM_NEWTON_THRESHOLD || k < DIVREM_NEWTON_THRESHOLD) {
+        q = a / b;
+        r = a - q * b;
+    } else {
+        size_t p = la - k + 1;
+        big_integer x = reciprocal(b, p);
+        q = mul_high(a >> static_cast<int>(32 * (k - 1)), x, p + 1);
+        r = wrap_signed(a - mul_low(q, b, k + 1), k + 1);
+        while (r < 0) {
+            r += b;
+            q -= 1;
+        }
+        while (r >= b) {
+            r -= b;
+            q += 1;
+        }
+    }
+    if ((first < 0) != (second < 0)) {
+        q = -q;
+    }
+    if (first < 0) {
+        r = -r;
+    }
+    return {q, r};
+}
+
+namespace {
+    // The pairs of a level are independent, so a level large enough to pay
+    // for the threads has them multiplied in parallel; bit_length() is only
+    // a size estimate here, the values may be negative.
+    std::vector<big_integer> multiply_neighbours(std::vector<big_integer> const &values) {
+        size_t bits = 0;
+        for (big_integer const &value : values) {
+            bits += value.bit_length();
+        }
+        std::vector<big_integer> result((values.size() + 1) / 2);
+        parallel_for(values.size() / 2, bits >= PARALLEL_MIN_BITS, [&values, &result](size_t i) {
+            result[i] = values[2 * i] * values[2 * i + 1];
+        });
+        if (values.size() % 2 == 1) {
+            result.back() = values.back();
+        }
+        return result;
+    }
+}
+
+// Neighbours are multiplied level by level, so operands of similar length meet
+// at every level instead of one growing accumulator absorbing small factors.
+big_integer product(std::vector<big_integer> values) {
+    if (values.empty()) {
+        return 1;
+    }
+    while (values.size() > 1) {
+        values = multiply_neighbours(values);
+    }
+    return values[0];
+}
+
+std::vector<std::vector<big_integer>> subproduct_tree(std::vector<big_integer> const &values) {
+    std::vector<std::vector<big_integer>> levels;
+    if (values.empty()) {
+        return levels;
+    }
+    levels.push_back(values);
+    while (levels.back().size() > 1) {
+        std::vector<big_integer> above = multiply_neighbours(levels.back());
+        levels.push_back(above);
+    }
+    return levels;
+}
+
+// n is reduced modulo the root of the product tree of the moduli and each
+// remainder is pushed down to the two children, so every division is by a
+// divisor about half the length of its dividend.
+std::vector<big_integer> remainder_tree(big_integer const &n, std::vector<big_integer> const &moduli) {
+    if (moduli.empty()) {
+        return {};
+    }
+    std::vector<std::vector<big_integer>> levels = subproduct_tree(moduli);
+    std::vector<big_integer> remainders(1, divrem(n, levels.back()[0]).second);
+    for (size_t level = levels.size() - 1; level-- > 0;) {
+        std::vector<big_integer> below;
+        below.reserve(levels[level].size());
+        for (size_t i = 0; i < levels[level].size(); ++i) {
+            below.push_back(divrem(remainders[i / 2], levels[level][i]).second);
+        }
+        remainders.swap(below);
+    }
+    return remainders;
+}
@@ -4,6 +4,27 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <utility>
+
+// A nonzero word divisor kept with its normalised form d' = d * 2^shift and
+// the reciprocal floor((2^128 - 1) / d') - 2^64, so that remainders by the
+// same word reuse the setup and cost one multiplication per 64-bit word
+// (Moller and Granlund's 2-by-1 division).
+class word_divisor {
+public:
+    explicit word_divisor(uint64_t divisor);
+
+    uint64_t value() const;
+
+    // (high * 2^64 + low) mod d, for high < d.
+    uint64_t remainder(uint64_t high, uint64_t low) const;
+
+private:
+    uint64_t divisor;
+    uint64_t normalized;
+    uint64_t inverse;
+    unsigned shift;
+};
 
 class big_integer {
     union {
@@ -16,6 +37,8 @@ class big_integer {
 
     friend std::string to_string(big_integer const &big_int);
 
+    friend class big_integer_limbs;
+
     void normalize();
 
     int compare(big_integer const &big_int) const;
@@ -37,6 +60,8 @@ class big_integer {
 
     void multiply_by_big(big_integer const &second);
 
+    void square();
+
     void bitwise_not();
 
     void negate();
@@ -57,6 +82,10 @@ class big_integer {
 
     void set_digit(size_t pos, uint32_t value);
 
+    std::vector<uint32_t> digits() const;
+
+    static big_integer from_digits(std::vector<uint32_t> digits);
+
 public:
     big_integer() noexcept;
 
@@ -134,7 +163,58 @@ public:
 
     big_integer const operator--(int);
 
+    uint32_t mod_u32(uint32_t divisor) const;
+
+    uint64_t mod_u64(uint64_t divisor) const;
+
+    uint64_t mod_u64(word_divisor const &divisor) const;
+
+    bool divisible_by(uint64_t divisor) const;
+
+    bool divisible_by(word_divisor const &divisor) const;
+
+    // bit_length() and trailing_zeros() take the magnitude of a non-negative
+    // value (trailing_zeros(0) is 0).
+    size_t bit_length() const;
+
+    size_t trailing_zeros() const;
+
+    uint64_t to_uint64() const;
+
+    static big_integer from_uint64(uint64_t value);
+
     ~big_integer();
 };
 
-#endif
\ No newline at end of file
+big_integer isqrt(big_integer const &n);
+
+std::pair<big_integer, big_integer> sqrtrem(big_integer const &n);
+
+big_integer root(big_integer const &n, uint32_t k);
+
+std::pair<big_integer, big_integer> rootrem(big_integer const &n, uint32_t k);
+
+bool is_perfect_square(big_integer const &n);
+
+bool is_perfect_power(big_integer const &n);
+
+big_integer mul_low(big_integer const &first, big_integer const &second, size_t n);
+
+big_integer mul_high(big_integer const &first, big_integer const &second, size_t n);
+
+big_integer divexact(big_integer const &first, big_integer const &second);
+
+std::pair<big_integer, big_integer> divrem(big_integer const &first, big_integer const &second);
+
+big_integer product(std::vector<big_integer> values);
+
+template<class Iterator>
+big_integer product(Iterator begin, Iterator end) {
+    return product(std::vector<big_integer>(begin, end));
+}
+
+std::vector<std::vector<big_integer>> subproduct_tree(std::vector<big_integer> const &values);
+
+std::vector<big_integer> remainder_tree(big_integer const &n, std::vector<big_integer> const &moduli);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef BIG_INTEGER_LIMBS_H
+#define BIG_INTEGER_LIMBS_H
+
+#include "big_integer.h"
+
+// Limb-level access for the arithmetic built on top of big_integer; not part
+// of its public interface. digits() holds the low limbs of the two's
+// complement form, everything above being sign extension, and from_digits()
+// reads a non-negative value back from them.
+class big_integer_limbs {
+public:
+    static std::vector<uint32_t> digits(big_integer const &value) {
+        return value.digits();
+    }
+
+    static big_integer from_digits(std::vector<uint32_t> digits) {
+        return big_integer::from_digits(std::move(digits));
+    }
+};
+
+#endif
@@ -6,6 +6,16 @@
 #include <gtest/gtest.h>
 
 #include "big_integer.h"
+#include "big_integer_limbs.h"
+#include "barrett.h"
+#include "big_float.h"
+#include "big_rational.h"
+#include "fixed_base_powmod.h"
+#include "modular.h"
+#include "montgomery.h"
+#include "number_theory.h"
+#include "pseudo_mersenne.h"
+#include "rns_integer.h"
 
 TEST(correctness, two_plus_two)
 {
@@ -598,6 +608,53 @@ EXPECT_EQ(big_integer("-1591563309890326054125627839548891585559049824963"),
 
 }
 
+TEST(correctness, add_long_carry)
+{
+big_integer a("100000000000000000000");
+
+EXPECT_EQ(0 + a, a);
+EXPECT_EQ(big_integer(2147483647) + 1 + 2147483647 + 1, big_integer(1) << 32);
+}
+
+TEST(correctness, shl_long_signed)
+{
+EXPECT_EQ(big_integer(-1) << 31, std::numeric_limits<int>::min());
+EXPECT_EQ(big_integer(-1) << 64, -(big_integer(1) << 64));
+}
+
+TEST(correctness, compare_long_signed)
+{
+EXPECT_LT(big_integer("-14359731685826847253"), big_integer("-545561755700857411"));
+EXPECT_GT(big_integer(-1423816421), big_integer("-4294967296"));
+}
+
+TEST(correctness, div_long_max_digit)
+{
+big_integer a("36893488147419103231");
+big_integer b("18446744073709551615");
+
+EXPECT_EQ(a / b, 2);
+EXPECT_EQ(a % b, 1);
+}
+
+TEST(correctness, div_long_zero_digit)
+{
+big_integer a = big_integer(1) << 192;
+big_integer b("18446744073709551629");
+
+EXPECT_EQ(a / b, big_integer("340282366920938463223566934473544040616"));
+EXPECT_EQ(a % b, big_integer("18446744073709549432"));
+}
+
+TEST(correctness, string_conv_keeps_argument)
+{
+big_integer a("100000000000000000000");
+big_integer b = a;
+to_string(a);
+
+EXPECT_EQ(to_string(b), "100000000000000000000");
+}
+
 TEST(correctness, string_conv)
 {
 EXPECT_EQ(to_string(big_integer("100")), "100");
@@ -734,4 +791,952 @@ ASSERT_EQ(divident - quotient * divisor, residue);
 EXPECT_GE(residue, 0);
 EXPECT_LT(residue, divisor);
 }
-}
\ No newline at end of file
+}
+TEST(correctness, isqrt_small)
+{
+for (int i = 0; i != 2000; ++i)
+{
+big_integer root = isqrt(i);
+EXPECT_LE(root * root, i);
+EXPECT_GT((root + 1) * (root + 1), i);
+}
+EXPECT_EQ(isqrt(big_integer("18446744073709551615")), big_integer("4294967295"));
+EXPECT_EQ(isqrt(big_integer("18446744073709551616")), big_integer("4294967296"));
+EXPECT_THROW(isqrt(-1), std::runtime_error);
+}
+
+TEST(correctness, sqrtrem_randomized)
+{
+for (size_t itn = 0; itn != number_of_iterations * 10; ++itn)
+{
+for (size_t size : {1, 3, 10, 80, 200})
+{
+big_integer n = rand_big(size);
+std::pair<big_integer, big_integer> sr = sqrtrem(n);
+ASSERT_EQ(sr.first * sr.first + sr.second, n);
+EXPECT_GE(sr.second, 0);
+EXPECT_LE(sr.second, sr.first * 2);
+EXPECT_EQ(isqrt(n), sr.first);
+}
+}
+}
+
+TEST(correctness, sqrtrem_perfect_square)
+{
+big_integer root = rand_big(150);
+std::pair<big_integer, big_integer> sr = sqrtrem(root * root);
+EXPECT_EQ(sr.first, root);
+EXPECT_EQ(sr.second, 0);
+}
+
+TEST(correctness, is_perfect_square_small)
+{
+std::vector<bool> squares(10000);
+for (int i = 0; i * i < 10000; ++i)
+squares[i * i] = true;
+
+for (int i = 0; i != 10000; ++i)
+EXPECT_EQ(is_perfect_square(i), squares[i]);
+EXPECT_FALSE(is_perfect_square(-4));
+}
+
+TEST(correctness, is_perfect_square_long)
+{
+for (size_t itn = 0; itn != number_of_iterations; ++itn)
+{
+big_integer root = rand_big(40);
+big_integer square = root * root;
+EXPECT_TRUE(is_perfect_square(square));
+EXPECT_FALSE(is_perfect_square(square + 1));
+EXPECT_FALSE(is_perfect_square(square - 1));
+}
+}
+
+TEST(correctness, is_perfect_power_small)
+{
+std::vector<bool> powers(20000);
+powers[0] = powers[1] = true;
+for (int base = 2; base * base < 20000; ++base)
+for (int power = base * base; power < 20000; power *= base)
+powers[power] = true;
+
+for (int i = 0; i != 20000; ++i)
+EXPECT_EQ(is_perfect_power(i), powers[i]);
+EXPECT_TRUE(is_perfect_power(-1));
+EXPECT_TRUE(is_perfect_power(-8));
+EXPECT_TRUE(is_perfect_power(-243));
+EXPECT_FALSE(is_perfect_power(-4));
+EXPECT_FALSE(is_perfect_power(-16));
+}
+
+TEST(correctness, is_perfect_power_long)
+{
+for (size_t itn = 0; itn != number_of_iterations; ++itn)
+{
+big_integer base = rand_big(5);
+for (int k : {2, 3, 5, 7})
+{
+big_integer value = 1;
+for (int i = 0; i != k; ++i)
+value *= base;
+EXPECT_TRUE(is_perfect_power(value));
+EXPECT_FALSE(is_perfect_power(value + 1));
+if (k % 2 == 1)
+{
+EXPECT_TRUE(is_perfect_power(-value));
+}
+}
+}
+}
+
+TEST(correctness, root_small)
+{
+for (uint32_t k = 1; k != 7; ++k)
+{
+for (int i = 0; i != 5000; ++i)
+{
+big_integer r = root(i, k);
+big_integer low = 1;
+big_integer high = 1;
+for (uint32_t j = 0; j != k; ++j)
+{
+low *= r;
+high *= r + 1;
+}
+EXPECT_LE(low, i);
+EXPECT_GT(high, i);
+}
+}
+EXPECT_EQ(root(-27, 3), -3);
+EXPECT_EQ(root(-30, 3), -3);
+EXPECT_THROW(root(-4, 2), std::runtime_error);
+EXPECT_THROW(root(4, 0), std::runtime_error);
+}
+
+TEST(correctness, rootrem_randomized)
+{
+for (size_t itn = 0; itn != number_of_iterations; ++itn)
+{
+for (uint32_t k : {2u, 3u, 5u, 17u, 100u})
+{
+big_integer n = rand_big(60);
+std::pair<big_integer, big_integer> rr = rootrem(n, k);
+big_integer low = 1;
+big_integer high = 1;
+for (uint32_t j = 0; j != k; ++j)
+{
+low *= rr.first;
+high *= rr.first + 1;
+}
+EXPECT_EQ(low + rr.second, n);
+EXPECT_GE(rr.second, 0);
+EXPECT_GT(high, n);
+}
+}
+}
+
+TEST(correctness, is_probable_prime_small)
+{
+std::vector<bool> composite(100000);
+for (int i = 2; i != 100000; ++i)
+{
+if (!composite[i])
+for (int j = 2 * i; j < 100000; j += i)
+composite[j] = true;
+EXPECT_EQ(is_probable_prime(i), !composite[i]);
+}
+EXPECT_FALSE(is_probable_prime(0));
+EXPECT_FALSE(is_probable_prime(1));
+EXPECT_FALSE(is_probable_prime(-7));
+}
+
+TEST(correctness, is_probable_prime_word)
+{
+EXPECT_TRUE(is_probable_prime(big_integer("18446744073709551557")));
+EXPECT_FALSE(is_probable_prime(big_integer("3825123056546413051")));
+EXPECT_FALSE(is_probable_prime(big_integer("318665857834031151167461")));
+EXPECT_FALSE(is_probable_prime(big_integer("3317044064679887385961981")));
+}
+
+TEST(correctness, is_probable_prime_long)
+{
+big_integer m127 = (big_integer(1) << 127) - 1;
+big_integer m521 = (big_integer(1) << 521) - 1;
+EXPECT_TRUE(is_probable_prime(m127));
+EXPECT_TRUE(is_probable_prime(m521));
+EXPECT_TRUE(is_probable_prime(m127, 1, false));
+EXPECT_FALSE(is_probable_prime((big_integer(1) << 128) + 1));
+EXPECT_FALSE(is_probable_prime(m127 * m521));
+EXPECT_FALSE(is_probable_prime(m127 * m127));
+EXPECT_FALSE(is_probable_prime(big_integer("2152302898747"), 1, false));
+}
+
+TEST(correctness, next_prime_small)
+{
+std::vector<int> primes;
+for (int i = 2; i != 20000; ++i)
+if (is_probable_prime(i))
+primes.push_back(i);
+
+EXPECT_EQ(next_prime(-5), 2);
+EXPECT_EQ(next_prime(0), 2);
+EXPECT_EQ(next_prime(2), 3);
+for (size_t i = 0; i + 1 != primes.size(); ++i)
+{
+EXPECT_EQ(next_prime(primes[i]), primes[i + 1]);
+EXPECT_EQ(next_prime(primes[i] + 1), primes[i + 1] == primes[i] + 1 ? primes[i + 2] : primes[i + 1]);
+}
+}
+
+TEST(correctness, next_prime_long)
+{
+big_integer m127 = (big_integer(1) << 127) - 1;
+EXPECT_EQ(next_prime(m127 - 2), m127);
+EXPECT_EQ(next_prime(big_integer(1) << 64), big_integer("18446744073709551629"));
+
+big_integer n = rand_big(20);
+big_integer p = next_prime(n);
+EXPECT_GT(p, n);
+EXPECT_TRUE(is_probable_prime(p));
+for (big_integer i = n + 1; i < p; ++i)
+EXPECT_FALSE(is_probable_prime(i));
+}
+
+TEST(correctness, prime_generator_range)
+{
+std::vector<big_integer> expected;
+for (int i = 0; i != 100000; ++i)
+if (is_probable_prime(i))
+expected.push_back(i);
+
+prime_generator generator(0, 100000);
+big_integer prime;
+size_t count = 0;
+while (generator.next(prime))
+{
+ASSERT_LT(count, expected.size());
+EXPECT_EQ(prime, expected[count]);
+++count;
+}
+EXPECT_EQ(count, 9592u);
+
+big_integer begin = (big_integer(1) << 200) + 12345;
+prime_generator window(begin, begin + 5000);
+big_integer previous = begin - 1;
+while (window.next(prime))
+{
+EXPECT_EQ(prime, next_prime(previous));
+previous = prime;
+}
+EXPECT_GE(next_prime(previous), begin + 5000);
+}
+
+TEST(correctness, factorial)
+{
+big_integer expected = 1;
+for (int n = 0; n != 600; ++n)
+{
+if (n > 0)
+expected *= n;
+EXPECT_EQ(factorial(n), expected);
+}
+EXPECT_EQ(to_string(factorial(25)), "15511210043330985984000000");
+}
+
+TEST(correctness, binomial)
+{
+std::vector<big_integer> row = {1};
+for (uint32_t n = 1; n != 150; ++n)
+{
+std::vector<big_integer> next(n + 1, 1);
+for (uint32_t k = 1; k != n; ++k)
+next[k] = row[k - 1] + row[k];
+row = next;
+for (uint32_t k = 0; k <= n; ++k)
+EXPECT_EQ(binomial(n, k), row[k]);
+EXPECT_EQ(binomial(n, n + 1), 0);
+}
+EXPECT_EQ(binomial(3000, 1234), factorial(3000) / factorial(1234) / factorial(1766));
+}
+
+TEST(correctness, binomial_small_k)
+{
+big_integer expected = 1;
+for (uint32_t k = 0; k != 260; ++k)
+{
+EXPECT_EQ(binomial(200000, k), expected);
+EXPECT_EQ(binomial(200000, 200000 - k), expected);
+expected = expected * (200000 - k) / (k + 1);
+}
+EXPECT_EQ(binomial(100000000, 2), big_integer("4999999950000000"));
+EXPECT_EQ(multinomial({100000, 3, 2}), binomial(100005, 5) * binomial(5, 2));
+EXPECT_EQ(multinomial({2, 100000, 0}), binomial(100002, 2));
+}
+
+TEST(correctness, multinomial)
+{
+EXPECT_EQ(multinomial({}), 1);
+EXPECT_EQ(multinomial({5}), 1);
+EXPECT_EQ(multinomial({2, 3}), binomial(5, 2));
+EXPECT_EQ(multinomial({1, 1, 1, 1}), 24);
+EXPECT_EQ(multinomial({0, 64, 64, 64}), factorial(192) / factorial(64) / factorial(64) / factorial(64));
+EXPECT_EQ(multinomial({100, 200, 300, 7}), factorial(607) / factorial(100) / factorial(200) / factorial(300) / factorial(7));
+}
+
+TEST(correctness, mul_square)
+{
+for (size_t itn = 0; itn != number_of_iterations; ++itn)
+{
+for (size_t size : {0, 1, 5, 40})
+{
+big_integer a = rand_big(size);
+big_integer b = a;
+EXPECT_EQ(a * a, a * (a + 1) - a);
+EXPECT_EQ(-a * -a, a * b);
+b *= b;
+EXPECT_EQ(b, a * (a - 1) + a);
+}
+}
+}
+
+TEST(correctness, fibonacci_lucas)
+{
+big_integer f0 = 0;
+big_integer f1 = 1;
+big_integer l0 = 2;
+big_integer l1 = 1;
+for (uint32_t n = 0; n != 1500; ++n)
+{
+std::pair<big_integer, big_integer> f = fibonacci(n);
+std::pair<big_integer, big_integer> l = lucas(n);
+EXPECT_EQ(f.first, f0);
+EXPECT_EQ(f.second, f1);
+EXPECT_EQ(l.first, l0);
+EXPECT_EQ(l.second, l1);
+f1 += f0;
+f0 = f1 - f0;
+l1 += l0;
+l0 = l1 - l0;
+}
+EXPECT_EQ(to_string(fibonacci(100).first), "354224848179261915075");
+}
+
+TEST(correctness, product)
+{
+std::vector<int> multipliers;
+for (size_t i = 0; i != number_of_multipliers; ++i)
+multipliers.push_back(myrand());
+
+big_integer accumulator = 1;
+for (int multiplier : multipliers)
+accumulator *= multiplier;
+
+EXPECT_EQ(product(multipliers.begin(), multipliers.end()), accumulator);
+EXPECT_EQ(product(multipliers.begin(), multipliers.begin() + 1), multipliers[0]);
+EXPECT_EQ(product(multipliers.begin(), multipliers.begin()), 1);
+
+std::vector<big_integer> values = {rand_big(30), -rand_big(3), 7, rand_big(12)};
+EXPECT_EQ(product(values.begin(), values.end()), values[0] * values[1] * values[2] * values[3]);
+}
+
+TEST(correctness, remainder_tree)
+{
+big_integer n = rand_big(200);
+std::vector<big_integer> moduli;
+for (size_t i = 0; i != 37; ++i)
+moduli.push_back(rand_big(i % 5 + 1) + 2);
+moduli.push_back(3);
+
+std::vector<big_integer> remainders = remainder_tree(n, moduli);
+ASSERT_EQ(remainders.size(), moduli.size());
+for (size_t i = 0; i != moduli.size(); ++i)
+EXPECT_EQ(remainders[i], n % moduli[i]);
+
+remainders = remainder_tree(-n, moduli);
+for (size_t i = 0; i != moduli.size(); ++i)
+EXPECT_EQ(remainders[i], -n % moduli[i]);
+
+EXPECT_TRUE(remainder_tree(n, std::vector<big_integer>()).empty());
+}
+
+TEST(correctness, divrem)
+{
+for (size_t itn = 0; itn != number_of_iterations; ++itn)
+{
+for (size_t size : {1, 10, 100, 300})
+{
+big_integer a = rand_big(size + 300);
+big_integer b = rand_big(size);
+for (int signs = 0; signs != 4; ++signs)
+{
+big_integer x = signs & 1 ? -a : a;
+big_integer y = signs & 2 ? -b : b;
+std::pair<big_integer, big_integer> qr = divrem(x, y);
+EXPECT_EQ(qr.first, x / y);
+EXPECT_EQ(qr.second, x % y);
+}
+}
+}
+big_integer b = (big_integer(1) << 4000) - 1;
+EXPECT_EQ(divrem(b * b, b).second, 0);
+EXPECT_EQ(divrem(b * b - 1, b).second, b - 1);
+EXPECT_EQ(divrem(b * (b + 2), b + 1), std::make_pair(b, b));
+EXPECT_THROW(divrem(b, 0), std::runtime_error);
+
+std::vector<big_integer> moduli;
+for (size_t i = 0; i != 9; ++i)
+moduli.push_back(rand_big(80 + i));
+big_integer n = rand_big(1000);
+std::vector<big_integer> remainders = remainder_tree(n, moduli);
+for (size_t i = 0; i != moduli.size(); ++i)
+EXPECT_EQ(remainders[i], n % moduli[i]);
+}
+
+TEST(correctness, gcd)
+{
+EXPECT_EQ(gcd(0, 0), 0);
+EXPECT_EQ(gcd(0, -5), 5);
+EXPECT_EQ(gcd(-12, 18), 6);
+
+big_integer common = rand_big(4) + 1;
+big_integer a = rand_big(20) * common;
+big_integer b = rand_big(15) * common;
+big_integer g = gcd(a, b);
+EXPECT_EQ(a % g, 0);
+EXPECT_EQ(b % g, 0);
+EXPECT_EQ(g % common, 0);
+EXPECT_EQ(gcd(a / g, b / g), 1);
+}
+
+TEST(correctness, batch_gcd)
+{
+std::vector<big_integer> primes;
+big_integer p = next_prime(big_integer("1000000000000000000000000000"));
+for (size_t i = 0; i != 9; ++i)
+{
+primes.push_back(p);
+p = next_prime(p + 1);
+}
+
+std::vector<big_integer> moduli = {primes[0] * primes[1], primes[2] * primes[3], primes[4] * primes[5],
+primes[1] * primes[6], primes[7] * primes[8], primes[3] * primes[5]};
+std::vector<big_integer> expected = {primes[1], primes[3], primes[5], primes[1], 1, primes[3] * primes[5]};
+EXPECT_EQ(batch_gcd(moduli), expected);
+
+for (size_t i = 0; i != moduli.size(); ++i)
+{
+big_integer others = 1;
+for (size_t j = 0; j != moduli.size(); ++j)
+if (j != i)
+others *= moduli[j];
+EXPECT_EQ(batch_gcd(moduli)[i], gcd(moduli[i], others));
+}
+}
+
+TEST(correctness, mod_inverse)
+{
+EXPECT_EQ(mod_inverse(3, 7), 5);
+EXPECT_EQ(mod_inverse(-3, 7), 2);
+EXPECT_THROW(mod_inverse(6, 9), std::runtime_error);
+
+big_integer m = next_prime(rand_big(10));
+big_integer a = rand_big(12);
+EXPECT_EQ(a * mod_inverse(a, m) % m, 1);
+}
+
+TEST(correctness, crt_basis)
+{
+std::vector<big_integer> moduli;
+big_integer p = next_prime(rand_big(3));
+for (size_t i = 0; i != 13; ++i)
+{
+moduli.push_back(p);
+p = next_prime(p + 1);
+}
+moduli.push_back(big_integer(1) << 40);
+crt_basis basis(moduli);
+EXPECT_EQ(basis.modulus(), product(moduli.begin(), moduli.end()));
+
+for (size_t t = 0; t != 10; ++t)
+{
+big_integer x = rand_big(30) % basis.modulus();
+std::vector<big_integer> residues = remainder_tree(x, moduli);
+EXPECT_EQ(basis.reconstruct(residues), x);
+}
+
+EXPECT_THROW(crt_basis(std::vector<big_integer>({6, 10})), std::runtime_error);
+EXPECT_THROW(basis.reconstruct(std::vector<big_integer>(3)), std::runtime_error);
+}
+
+TEST(correctness, rns_integer)
+{
+std::shared_ptr<rns_basis const> basis = std::make_shared<rns_basis>(32);
+EXPECT_EQ(basis->size(), 32u);
+EXPECT_EQ(basis->prime(0), 2147483647u);
+
+big_integer a = rand_big(5);
+big_integer b = -rand_big(4);
+big_integer c = rand_big(3);
+rns_integer ra(basis, a);
+rns_integer rb(basis, b);
+rns_integer rc(basis, c);
+
+EXPECT_EQ(ra.to_big_integer(), a);
+EXPECT_EQ(rb.to_big_integer(), b);
+EXPECT_EQ((ra + rb).to_big_integer(), a + b);
+EXPECT_EQ((ra - rb).to_big_integer(), a - b);
+EXPECT_EQ((-ra).to_big_integer(), -a);
+EXPECT_EQ((ra * rb + rc).to_big_integer(), a * b + c);
+EXPECT_EQ((ra * rb * rc - rb * rb).to_big_integer(), a * b * c - b * b);
+
+std::shared_ptr<rns_basis const> other = std::make_shared<rns_basis>(2);
+EXPECT_THROW(ra + rns_integer(other, 1), std::runtime_error);
+}
+
+namespace
+{
+    template<class Context>
+    void check_modular(big_integer const &m)
+    {
+        std::shared_ptr<Context const> context = std::make_shared<Context>(m);
+        big_integer a = rand_big(12);
+        big_integer b = -rand_big(9);
+        modular<Context> x(context, a);
+        modular<Context> y(context, b);
+
+        auto reduce = [&m](big_integer v) { v %= m; return v < 0 ? v + m : v; };
+        EXPECT_EQ(x.value(), reduce(a));
+        EXPECT_EQ(y.value(), reduce(b));
+        EXPECT_EQ((x + y).value(), reduce(a + b));
+        EXPECT_EQ((x - y).value(), reduce(a - b));
+        EXPECT_EQ((-x).value(), reduce(-a));
+        EXPECT_EQ((x * y).value(), reduce(a * b));
+        EXPECT_EQ((x * x * y).value(), reduce(a * a * b));
+        EXPECT_TRUE(x * y == y * x);
+
+        big_integer expected = 1;
+        for (int i = 0; i != 37; ++i)
+            expected = reduce(expected * a);
+        EXPECT_EQ(x.pow(37).value(), expected);
+        EXPECT_EQ(x.pow(0).value(), 1);
+        if (gcd(a, m) == 1)
+        {
+            EXPECT_EQ((x * x.inverse()).value(), 1);
+            EXPECT_EQ((x.pow(-3) * x.pow(3)).value(), 1);
+        }
+    }
+}
+
+TEST(correctness, modular_montgomery)
+{
+check_modular<montgomery_context>(next_prime(rand_big(8)));
+check_modular<montgomery_context>(rand_big(5) * 2 + 1);
+check_modular<montgomery_context>(3);
+}
+
+TEST(correctness, modular_barrett)
+{
+check_modular<barrett_context>(next_prime(rand_big(8)));
+check_modular<barrett_context>(rand_big(5) * 2);
+check_modular<barrett_context>(big_integer(1) << 64);
+check_modular<barrett_context>((big_integer(1) << 96) - 1);
+check_modular<barrett_context>(2);
+EXPECT_THROW(barrett_context(1), std::runtime_error);
+}
+
+TEST(correctness, batch_invert)
+{
+big_integer m = next_prime(rand_big(6));
+std::vector<big_integer> values;
+for (size_t i = 0; i != 50; ++i)
+values.push_back(i % 7 == 3 ? -rand_big(8) : rand_big(4) + 1);
+
+std::vector<big_integer> inverses = values;
+batch_invert(inverses, m);
+ASSERT_EQ(inverses.size(), values.size());
+for (size_t i = 0; i != values.size(); ++i)
+EXPECT_EQ(inverses[i], mod_inverse(values[i], m));
+
+std::vector<big_integer> single = {3};
+batch_invert(single, 10);
+EXPECT_EQ(single[0], 7);
+
+std::vector<big_integer> not_invertible = {3, 4, 5};
+EXPECT_THROW(batch_invert(not_invertible, 10), std::runtime_error);
+}
+
+TEST(correctness, binary_splitting)
+{
+auto one = [](uint32_t) { return big_integer(1); };
+auto index = [](uint32_t k) { return big_integer(k == 0 ? 1 : static_cast<int>(k)); };
+series_sum e = binary_splitting(one, index, one, 0, 60);
+big_integer digits = e.t * big_integer("1000000000000000000000000000000000000000000000000") / e.q;
+EXPECT_EQ(to_string(digits), "2718281828459045235360287471352662497757247093699");
+
+auto alternating = [](uint32_t k) { return big_integer(k % 2 == 0 ? 3 : -5); };
+auto square = [](uint32_t k) { return big_integer(static_cast<int>(k * k + 1)); };
+std::vector<big_integer> prefix_p, prefix_q;
+big_integer p = 1;
+big_integer q = 1;
+for (uint32_t k = 3; k != 17; ++k)
+{
+p *= alternating(k);
+q *= square(k);
+prefix_p.push_back(p);
+prefix_q.push_back(q);
+}
+big_integer t = 0;
+for (size_t i = 0; i != prefix_p.size(); ++i)
+t += index(static_cast<uint32_t>(i + 3)) * prefix_p[i] * (q / prefix_q[i]);
+
+series_sum s = binary_splitting(alternating, square, index, 3, 17);
+EXPECT_EQ(s.p, p);
+EXPECT_EQ(s.q, q);
+EXPECT_EQ(s.t, t);
+
+series_sum empty = binary_splitting(one, one, one, 5, 5);
+EXPECT_EQ(empty.t, 0);
+EXPECT_EQ(empty.q, 1);
+
+series_sum long_e = binary_splitting(one, index, one, 0, 2000);
+big_integer horner_t = 0;
+big_integer horner_q = 1;
+for (uint32_t k = 2000; k-- > 0;)
+{
+horner_t += horner_q;
+horner_q *= index(k);
+}
+EXPECT_EQ(long_e.q, horner_q);
+EXPECT_EQ(long_e.t, horner_t);
+}
+
+TEST(correctness, big_float_rounding)
+{
+big_float x(big_integer(0x2ff), 0, 8);
+EXPECT_EQ(x.mantissa(), 3);
+EXPECT_EQ(x.exponent(), 8);
+EXPECT_EQ(big_float(big_integer(0x281), 0, 8).mantissa(), 5);
+EXPECT_EQ(big_float(big_integer(0x283), 0, 8).mantissa(), 161);
+EXPECT_EQ(big_float(big_integer(-0x281), 0, 8).mantissa(), -5);
+EXPECT_EQ(big_float(big_integer(0x282), 0, 8).exponent(), 7);
+EXPECT_EQ(big_float(big_integer(0x286), 0, 8).mantissa(), 81);
+
+big_float third = big_float(big_integer(1), 10) / big_float(big_integer(3), 10);
+EXPECT_EQ(third.mantissa(), 683);
+EXPECT_EQ(third.exponent(), -11);
+
+big_float one(big_integer(1), 20);
+big_float tiny(big_integer(1), -100, 20);
+EXPECT_EQ(one + tiny, one);
+EXPECT_EQ(one - tiny, one);
+EXPECT_EQ((one - tiny) - tiny, one);
+big_float half_ulp(big_integer(1), -20, 20);
+EXPECT_EQ(one + half_ulp, one);
+EXPECT_EQ(one + half_ulp + tiny, one);
+EXPECT_EQ(one.with_precision(200) + half_ulp + tiny, (one.with_precision(200) + half_ulp) + tiny);
+}
+
+TEST(correctness, big_float_arithmetic)
+{
+size_t precision = 200;
+big_float two(big_integer(2), precision);
+big_float root = sqrt(two);
+std::pair<big_integer, big_integer> exact = sqrtrem(big_integer(2) << (2 * 199));
+EXPECT_EQ(root.mantissa() << static_cast<int>(root.exponent() + 199), exact.first + (exact.second > exact.first ? 1 : 0));
+
+big_float a(rand_big(5), -150, 2 * precision);
+big_float b(-rand_big(3), 20, 2 * precision);
+EXPECT_EQ(a + b, b + a);
+EXPECT_EQ(b - b, big_float(2 * precision));
+EXPECT_EQ((a * b) / b, a);
+EXPECT_EQ(a * b, b * a);
+EXPECT_TRUE(b < a);
+EXPECT_TRUE(-a < a);
+EXPECT_EQ(big_float(big_integer(-7), -1, 8).to_big_integer(), -3);
+EXPECT_EQ(big_float(big_integer(5), 3, 8).to_big_integer(), 40);
+EXPECT_THROW(a / big_float(precision), std::runtime_error);
+EXPECT_THROW(sqrt(b), std::runtime_error);
+}
+
+TEST(correctness, big_rational)
+{
+big_rational half(1, 2);
+big_rational third(-2, -6);
+EXPECT_EQ(to_string(half + third), "5/6");
+EXPECT_EQ(to_string(half - third), "1/6");
+EXPECT_EQ(to_string(half * third), "1/6");
+EXPECT_EQ(to_string(half / third), "3/2");
+EXPECT_EQ(to_string(half + half), "1");
+EXPECT_EQ(to_string(big_rational(6, -4)), "-3/2");
+EXPECT_EQ(big_rational(6, -4).denominator(), 2);
+EXPECT_EQ(to_string(big_rational(5, 6) + big_rational(1, 10)), "14/15");
+EXPECT_EQ(to_string(big_rational(1, 6) - big_rational(1, 6)), "0");
+EXPECT_TRUE(third < half);
+EXPECT_TRUE(big_rational(4, 6) == big_rational(-2, -3));
+EXPECT_THROW(big_rational(1, 0), std::runtime_error);
+EXPECT_THROW(half / big_rational(), std::runtime_error);
+
+big_rational harmonic;
+big_integer lcm = 1;
+for (int k = 1; k <= 200; ++k)
+{
+harmonic += big_rational(1, k);
+lcm = lcm / gcd(lcm, k) * k;
+}
+big_rational sum;
+for (int k = 1; k <= 200; ++k)
+sum = sum + big_rational(lcm / k, lcm);
+EXPECT_EQ(harmonic, sum);
+EXPECT_EQ(gcd(harmonic.numerator(), harmonic.denominator()), 1);
+
+big_rational product(1);
+for (int k = 1; k <= 300; ++k)
+product *= big_rational(k + 1, k);
+EXPECT_EQ(to_string(product), "301");
+}
+
+TEST(correctness, big_rational_add_unreduced)
+{
+big_rational a(2, 3);
+EXPECT_EQ(a.numerator(), 2);
+a += big_rational(4, 6);
+EXPECT_EQ(to_string(a), "4/3");
+EXPECT_EQ(a.numerator(), 4);
+
+big_rational b(1, 3);
+EXPECT_EQ(to_string(b), "1/3");
+EXPECT_EQ(to_string(b - big_rational(2, 6)), "0");
+EXPECT_EQ((b - big_rational(2, 6)).denominator(), 1);
+}
+
+TEST(correctness, mul_low_high)
+{
+for (size_t t = 0; t != 20; ++t)
+{
+big_integer a = rand_big(t + 1);
+big_integer b = rand_big(2 * t + 3);
+if (t % 4 == 1)
+a = -a;
+big_integer full = a * b;
+for (size_t n = 0; n != 3 * t + 8; ++n)
+{
+big_integer low = full % (big_integer(1) << static_cast<int>(32 * n));
+if (low < 0)
+low += big_integer(1) << static_cast<int>(32 * n);
+EXPECT_EQ(mul_low(a, b, n), low);
+if (a >= 0)
+{
+EXPECT_EQ(mul_high(a, b, n), full >> static_cast<int>(32 * n));
+}
+}
+}
+
+big_integer ones = (big_integer(1) << 640) - 1;
+big_integer almost = (big_integer(1) << 320) - 3;
+for (int n = 0; n != 32; ++n)
+{
+EXPECT_EQ(mul_high(ones, ones, n), (ones * ones) >> (32 * n));
+EXPECT_EQ(mul_high(ones, almost, n), (ones * almost) >> (32 * n));
+}
+EXPECT_THROW(mul_high(-ones, ones, 3), std::runtime_error);
+
+big_integer x = rand_big(90);
+big_integer y = rand_big(100);
+for (int n : {0, 45, 90, 170, 200})
+{
+EXPECT_EQ(mul_high(x, y, n), (x * y) >> (32 * n));
+EXPECT_EQ(mul_low(x, y, n), (x * y) % (big_integer(1) << (32 * n)));
+}
+}
+
+TEST(correctness, mul_long_unbalanced)
+{
+size_t sizes[][2] = {{45, 45}, {90, 47}, {130, 45}, {300, 41}, {97, 3}, {170, 115}, {240, 115}, {330, 115}};
+for (auto const &size : sizes)
+{
+big_integer a = rand_big(size[0]);
+big_integer b = -rand_big(size[1]);
+big_integer c = a * b;
+EXPECT_EQ(c / b, a);
+EXPECT_EQ(c % b, 0);
+EXPECT_EQ(c, b * a);
+EXPECT_EQ(a * a, (a - 1) * (a + 1) + 1);
+
+big_integer ones_a = (big_integer(1) << static_cast<int>(32 * size[0])) - 1;
+big_integer ones_b = (big_integer(1) << static_cast<int>(32 * size[1])) - 1;
+EXPECT_EQ(ones_a * ones_b, (ones_a << static_cast<int>(32 * size[1])) - ones_a);
+}
+}
+
+TEST(correctness, divexact)
+{
+size_t sizes[][2] = {{1, 1}, {5, 3}, {20, 1}, {100, 90}, {200, 100}, {300, 120}};
+for (auto const &size : sizes)
+{
+big_integer b = rand_big(size[1]) << static_cast<int>(size[0] % 37);
+big_integer q = rand_big(size[0]);
+big_integer a = q * b;
+EXPECT_EQ(divexact(a, b), q);
+EXPECT_EQ(divexact(-a, b), -q);
+EXPECT_EQ(divexact(a, -b), -q);
+EXPECT_EQ(divexact(a, q), b);
+}
+EXPECT_EQ(divexact(0, 7), 0);
+EXPECT_EQ(divexact(big_integer(1) << 200, big_integer(1) << 150), big_integer(1) << 50);
+EXPECT_THROW(divexact(5, 0), std::runtime_error);
+}
+
+TEST(correctness, modular_pseudo_mersenne)
+{
+uint32_t shapes[][2] = {{255, 19}, {127, 1}, {64, 59}, {61, 1}, {32, 5}, {3, 1}, {100, 0xFFFFFFFF}};
+for (auto const &shape : shapes)
+{
+std::shared_ptr<pseudo_mersenne_context const> context = std::make_shared<pseudo_mersenne_context>(shape[0], shape[1]);
+big_integer m = context->modulus();
+EXPECT_EQ(m, (big_integer(1) << static_cast<int>(shape[0])) - big_integer(static_cast<int>(shape[1] >> 1u)) * 2 - static_cast<int>(shape[1] & 1u));
+for (size_t t = 0; t != 10; ++t)
+{
+big_integer a = rand_big(t + 1) % m;
+big_integer b = m - 1 - rand_big(t % 3) % m;
+modular<pseudo_mersenne_context> x(context, a);
+modular<pseudo_mersenne_context> y(context, b);
+EXPECT_EQ((x * y).value(), a * b % m);
+EXPECT_EQ((x * x).value(), a * a % m);
+EXPECT_EQ((x + y).value(), (a + b) % m);
+EXPECT_EQ((x - y).value(), ((a - b) % m + m) % m);
+}
+}
+EXPECT_THROW(pseudo_mersenne_context(3, 4), std::runtime_error);
+}
+
+TEST(correctness, lucas_lehmer)
+{
+std::vector<uint32_t> exponents;
+for (uint32_t p = 2; p != 130; ++p)
+if (lucas_lehmer(p))
+exponents.push_back(p);
+EXPECT_EQ(exponents, std::vector<uint32_t>({2, 3, 5, 7, 13, 17, 19, 31, 61, 89, 107, 127}));
+EXPECT_TRUE(lucas_lehmer(521));
+EXPECT_TRUE(lucas_lehmer(607));
+EXPECT_FALSE(lucas_lehmer(523));
+}
+
+TEST(correctness, fixed_base_powmod)
+{
+big_integer m = next_prime(rand_big(8));
+big_integer g = rand_big(6) % m;
+std::shared_ptr<montgomery_context const> context = std::make_shared<montgomery_context>(m);
+fixed_base_powmod<montgomery_context> comb(context, g, 256);
+fixed_base_powmod<montgomery_context> single_column(context, g, 100, 3, 1);
+fixed_base_powmod<barrett_context> even(std::make_shared<barrett_context>(m * 2), g, 64, 4, 16);
+
+modular<montgomery_context> base(context, g);
+big_integer exponents[] = {0, 1, 2, 3, 255, rand_big(4), rand_big(7), rand_big(12)};
+for (big_integer const &e : exponents)
+{
+EXPECT_EQ(comb.power(e), base.pow(e).value());
+EXPECT_EQ(single_column.power(e), base.pow(e).value());
+}
+big_integer expected = 1;
+for (int i = 0; i != 50; ++i)
+expected = expected * g % (m * 2);
+EXPECT_EQ(even.power(50), expected);
+EXPECT_THROW(comb.power(-1), std::runtime_error);
+}
+
+TEST(correctness, multi_powmod)
+{
+big_integer moduli[] = {next_prime(rand_big(6)), rand_big(5) * 2, 3};
+for (big_integer const &m : moduli)
+{
+std::shared_ptr<barrett_context const> context = std::make_shared<barrett_context>(m);
+std::vector<std::pair<big_integer, big_integer>> terms;
+modular<barrett_context> expected(context, 1);
+for (size_t i = 0; i != 4; ++i)
+{
+big_integer base = rand_big(i + 3);
+big_integer exponent = rand_big(i * 3);
+terms.emplace_back(base, exponent);
+expected *= modular<barrett_context>(context, base).pow(exponent);
+}
+EXPECT_EQ(multi_powmod(terms, m), expected.value());
+}
+
+big_integer p = next_prime(rand_big(4));
+EXPECT_EQ(multi_powmod({{5, -3}, {5, 3}}, p), 1);
+EXPECT_EQ(multi_powmod({}, p), 1);
+EXPECT_EQ(multi_powmod({{7, 0}, {0, 5}}, p), 0);
+EXPECT_EQ(multi_powmod({{7, 10}}, 1), 0);
+}
+
+TEST(correctness, mod_u32_u64)
+{
+uint64_t divisors[] = {1, 2, 3, 7, 4294967295u, 4294967311u, 18446744073709551615u, 9223372036854775808u,
+                       12345678901234567u};
+for (size_t i = 0; i != 40; ++i)
+{
+big_integer value = rand_big(i % 13);
+if (i % 2)
+value = -value;
+for (uint64_t d : divisors)
+{
+big_integer expected = value % big_integer(std::to_string(d));
+if (expected < 0)
+expected += big_integer(std::to_string(d));
+EXPECT_EQ(value.mod_u64(d), std::stoull(to_string(expected)));
+EXPECT_EQ(value.divisible_by(d), expected == 0);
+}
+uint32_t r = value.mod_u32(1000003);
+EXPECT_EQ(big_integer(r), (value % 1000003 + 1000003) % 1000003);
+}
+
+big_integer big("340282366920938463463374607431768211455");
+EXPECT_EQ(big.mod_u64(18446744073709551615u), 0u);
+EXPECT_TRUE(big.divisible_by(4294967297u));
+EXPECT_EQ((-big).mod_u64(18446744073709551614u), 18446744073709551611u);
+EXPECT_EQ(big_integer(-1).mod_u32(4294967295u), 4294967294u);
+EXPECT_EQ(big_integer(0).mod_u64(7), 0u);
+EXPECT_THROW(big.mod_u64(0), std::runtime_error);
+EXPECT_THROW(big.divisible_by(0), std::runtime_error);
+
+word_divisor d(1000000007);
+big_integer value = -(rand_big(40) << 1000);
+EXPECT_EQ(big_integer::from_uint64(value.mod_u64(d)), (value % 1000000007 + 1000000007) % 1000000007);
+EXPECT_EQ(value.divisible_by(d), value.mod_u64(1000000007) == 0);
+EXPECT_EQ(d.remainder(1000000006, 18446744073709551615u),
+          ((big_integer(1000000006) << 64) + big_integer::from_uint64(18446744073709551615u)) % 1000000007);
+EXPECT_EQ(word_divisor(1).remainder(0, 12345), 0u);
+EXPECT_THROW(word_divisor(0), std::runtime_error);
+}
+
+TEST(correctness, limb_helpers)
+{
+big_integer a("340282366920938463463374607431768211456");
+EXPECT_EQ(a.bit_length(), 129u);
+EXPECT_EQ(a.trailing_zeros(), 128u);
+EXPECT_EQ(big_integer(0).bit_length(), 0u);
+EXPECT_EQ(big_integer(0).trailing_zeros(), 0u);
+EXPECT_EQ(big_integer::from_uint64(18446744073709551615u), big_integer("18446744073709551615"));
+EXPECT_EQ(big_integer("18446744073709551615").to_uint64(), 18446744073709551615u);
+EXPECT_EQ(big_integer_limbs::from_digits(big_integer_limbs::digits(a)), a);
+EXPECT_EQ(big_integer_limbs::from_digits({1, 0, 2}), (big_integer(2) << 64) + 1);
+EXPECT_EQ(big_integer_limbs::digits(-a), std::vector<uint32_t>(4, 0));
+}
+
+TEST(correctness, sign_limb_carry)
+{
+EXPECT_EQ(big_integer(2147483647) + 1, big_integer("2147483648"));
+EXPECT_EQ(big_integer(-2147483647) - 2, big_integer("-2147483649"));
+EXPECT_EQ(big_integer("4294967295") + 1, big_integer("4294967296"));
+EXPECT_EQ(big_integer("-4294967296") + 1, big_integer("-4294967295"));
+EXPECT_EQ(big_integer("2147483648") - 1, big_integer(2147483647));
+EXPECT_EQ(big_integer(1) << 31, big_integer("2147483648"));
+EXPECT_EQ(big_integer(-1) << 31, big_integer(-2147483647) - 1);
+EXPECT_EQ(big_integer(1073741824) << 33, big_integer("9223372036854775808"));
+EXPECT_EQ(big_integer(-3) << 63, big_integer("-27670116110564327424"));
+big_integer a = big_integer(2147483647);
+a += a;
+EXPECT_EQ(a, big_integer("4294967294"));
+EXPECT_EQ(a << 1 >> 1, a);
+EXPECT_EQ(-a - a, big_integer("-8589934588"));
+}
@@ -0,0 +1,177 @@
+#include "big_rational.h"
+#include "number_theory.h"
+#include <stdexcept>
+
+namespace {
+    size_t const REDUCE_SLACK_BITS = 2048;
+}
+
+big_rational::big_rational() : num(0), den(1), reduced(true), reduced_bits(0) {
+}
+
+big_rational::big_rational(big_integer const &value) : num(value), den(1), reduced(true), reduced_bits(0) {
+}
+
+big_rational::big_rational(big_integer const &numerator, big_integer const &denominator)
+        : num(numerator), den(denominator), reduced(false), reduced_bits(0) {
+    if (den == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+}
+
+big_integer const &big_rational::numerator() const {
+    canonicalize();
+    return num;
+}
+
+big_integer const &big_rational::denominator() const {
+    canonicalize();
+    return den;
+}
+
+void big_rational::canonicalize() const {
+    if (reduced) {
+        return;
+    }
+    big_integer g = gcd(num, den);
+    if (g != 1) {
+        num = divexact(num, g);
+        den = divexact(den, g);
+    }
+    reduced = true;
+    reduced_bits = den.bit_length();
+}
+
+// Reduction is amortised: it runs once the denominator is twice as long as it
+// was after the previous reduction, plus some slack for small values.
+void big_rational::reduce_if_grown() {
+    if (!reduced && den.bit_length() > 2 * reduced_bits + REDUCE_SLACK_BITS) {
+        canonicalize();
+    }
+}
+
+int big_rational::compare(big_rational const &second) const {
+    canonicalize();
+    second.canonicalize();
+    if (den == second.den) {
+        return num < second.num ? -1 : num > second.num ? 1 : 0;
+    }
+    big_integer left = num * second.den;
+    big_integer right = second.num * den;
+    return left < right ? -1 : left > right ? 1 : 0;
+}
+
+bool operator==(big_rational const &first, big_rational const &second) {
+    return first.compare(second) == 0;
+}
+
+bool operator!=(big_rational const &first, big_rational const &second) {
+    return first.compare(second) != 0;
+}
+
+bool operator<(big_rational const &first, big_rational const &second) {
+    return first.compare(second) < 0;
+}
+
+bool operator<=(big_rational const &first, big_rational const &second) {
+    return first.compare(second) <= 0;
+}
+
+bool operator>(big_rational const &first, big_rational const &second) {
+    return first.compare(second) > 0;
+}
+
+bool operator>=(big_rational const &first, big_rational const &second) {
+    return first.compare(second) >= 0;
+}
+
+big_rational big_rational::operator-() const {
+    big_rational result = *this;
+    result.num = -num;
+    return result;
+}
+
+// Knuth's addition (TAOCP 4.5.1): with d1 = gcd(b, d) the sum a/b + c/d is
+// t / ((b / d1) * d) for t = a * (d / d1) + c * (b / d1), so the cross
+// products stay small. When both operands are reduced, the only common factor
+// left is d2 = gcd(t, d1) and dividing it out keeps the sum reduced.
+big_rational &big_rational::operator+=(big_rational const &second) {
+    big_integer d1 = gcd(den, second.den);
+    if (d1 == 1) {
+        num = num * second.den + second.num * den;
+        den *= second.den;
+        reduced = reduced && second.reduced;
+    } else {
+        big_integer first_part = divexact(den, d1);
+        big_integer t = num * divexact(second.den, d1) + second.num * first_part;
+        if (reduced && second.reduced) {
+            big_integer d2 = gcd(t, d1);
+            num = divexact(t, d2);
+            den = first_part * divexact(second.den, d2);
+        } else {
+            num = t;
+            den = first_part * second.den;
+            reduced = false;
+        }
+    }
+    if (reduced) {
+        reduced_bits = den.bit_length();
+    }
+    reduce_if_grown();
+    return *this;
+}
+
+big_rational &big_rational::operator-=(big_rational const &second) {
+    return *this += -second;
+}
+
+big_rational &big_rational::operator*=(big_rational const &second) {
+    num *= second.num;
+    den *= second.den;
+    reduced = den == 1;
+    reduce_if_grown();
+    return *this;
+}
+
+big_rational &big_rational::operator/=(big_rational const &second) {
+    if (second.num == 0) {
+        throw std::runtime_error("Division by zero");
+    }
+    num *= second.den;
+    den *= second.num;
+    if (den < 0) {
+        num = -num;
+        den = -den;
+    }
+    reduced = den == 1;
+    reduce_if_grown();
+    return *this;
+}
+
+big_rational operator+(big_rational first, big_rational const &second) {
+    return first += second;
+}
+
+big_rational operator-(big_rational first, big_rational const &second) {
+    return first -= second;
+}
+
+big_rational operator*(big_rational first, big_rational const &second) {
+    return first *= second;
+}
+
+big_rational operator/(big_rational first, big_rational const &second) {
+    return first /= second;
+}
+
+std::string to_string(big_rational const &value) {
+    value.canonicalize();
+    if (value.den == 1) {
+        return to_string(value.num);
+    }
+    return to_string(value.num) + "/" + to_string(value.den);
+}
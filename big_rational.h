@@ -0,0 +1,69 @@
+#ifndef BIG_RATIONAL_H
+#define BIG_RATIONAL_H
+
+#include "big_integer.h"
+
+// An exact fraction whose gcd reduction is deferred until its size has grown
+// well past the size at the last reduction, or until it is compared, printed
+// or its numerator and denominator are read. The denominator is always
+// positive.
+class big_rational {
+public:
+    big_rational();
+
+    big_rational(big_integer const &value);
+
+    big_rational(big_integer const &numerator, big_integer const &denominator);
+
+    big_integer const &numerator() const;
+
+    big_integer const &denominator() const;
+
+    friend bool operator==(big_rational const &first, big_rational const &second);
+
+    friend bool operator!=(big_rational const &first, big_rational const &second);
+
+    friend bool operator<(big_rational const &first, big_rational const &second);
+
+    friend bool operator<=(big_rational const &first, big_rational const &second);
+
+    friend bool operator>(big_rational const &first, big_rational const &second);
+
+    friend bool operator>=(big_rational const &first, big_rational const &second);
+
+    big_rational operator-() const;
+
+    friend big_rational operator+(big_rational first, big_rational const &second);
+
+    friend big_rational operator-(big_rational first, big_rational const &second);
+
+    friend big_rational operator*(big_rational first, big_rational const &second);
+
+    friend big_rational operator/(big_rational first, big_rational const &second);
+
+    big_rational &operator+=(big_rational const &second);
+
+    big_rational &operator-=(big_rational const &second);
+
+    big_rational &operator*=(big_rational const &second);
+
+    big_rational &operator/=(big_rational const &second);
+
+    friend std::string to_string(big_rational const &value);
+
+private:
+    mutable big_integer num;
+    mutable big_integer den;
+    mutable bool reduced;
+    mutable size_t reduced_bits;
+
+    void canonicalize() const;
+
+    void reduce_if_grown();
+
+    int compare(big_rational const &second) const;
+};
+
+std::string to_string(big_rational const &value);
+
+#endif
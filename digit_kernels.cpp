@@ -0,0 +1,429 @@
+#include "digit_kernels.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+    size_t const HIGH_GUARD_DIGITS = 2;
+
+    size_t const TOOM_THRESHOLD = 100;
+
+    // Adds the partial products first[i] * second[j] with begin <= i + j < end
+    // into result[i + j - begin], which must hold end - begin zeroed digits.
+    void multiply_columns(uint32_t *result, uint32_t const *first, size_t first_len,
+                          uint32_t const *second, size_t second_len, size_t begin, size_t end) {
+        for (size_t i = 0; i < second_len && i < end; i++) {
+            uint64_t carry = 0;
+            uint64_t digit = second[i];
+            size_t j = begin > i ? begin - i : 0;
+            for (; j < first_len && i + j < end; j++) {
+                carry += result[i + j - begin] + first[j] * digit;
+                result[i + j - begin] = static_cast<uint32_t>(carry);
+                carry >>= 32u;
+            }
+            for (size_t k = i + j; carry != 0 && k < end; k++) {
+                carry += result[k - begin];
+                result[k - begin] = static_cast<uint32_t>(carry);
+                carry >>= 32u;
+            }
+        }
+    }
+}
+
+namespace {
+    // result[0, length) += value[0, value_len); digits of value at or above
+    // length must be zero.
+    void add_digits(uint32_t *result, size_t length, uint32_t const *value, size_t value_len) {
+        uint64_t carry = 0;
+        size_t i = 0;
+        for (; i < value_len && i < length; i++) {
+            carry += static_cast<uint64_t>(result[i]) + value[i];
+            result[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+        for (; carry != 0 && i < length; i++) {
+            carry += result[i];
+            result[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+    }
+
+    // result[0, length) -= value[0, value_len) for a value not above result.
+    void sub_digits(uint32_t *result, size_t length, uint32_t const *value, size_t value_len) {
+        uint64_t borrow = 0;
+        size_t i = 0;
+        for (; i < value_len; i++) {
+            uint64_t diff = static_cast<uint64_t>(result[i]) - value[i] - borrow;
+            result[i] = static_cast<uint32_t>(diff);
+            borrow = diff >> 63u;
+        }
+        for (; borrow != 0 && i < length; i++) {
+            uint64_t diff = static_cast<uint64_t>(result[i]) - borrow;
+            result[i] = static_cast<uint32_t>(diff);
+            borrow = diff >> 63u;
+        }
+    }
+
+    // Karatsuba for first_len >= second_len > first_len / 2: with the split
+    // h = first_len / 2 both high halves are non-empty and
+    // a * b = z2 * B^2h + ((a0 + a1)(b0 + b1) - z0 - z2) * B^h + z0.
+    void karatsuba(uint32_t *result, uint32_t const *first, size_t first_len,
+                   uint32_t const *second, size_t second_len) {
+        size_t h = first_len / 2;
+        size_t length = first_len + second_len;
+        std::vector<uint32_t> z0(2 * h);
+        std::vector<uint32_t> z2(length - 2 * h);
+        mul_digits(z0.data(), first, h, second, h);
+        mul_digits(z2.data(), first + h, first_len - h, second + h, second_len - h);
+        std::vector<uint32_t> first_sum(first_len - h + 1);
+        std::vector<uint32_t> second_sum(std::max(h, second_len - h) + 1);
+        std::copy(first + h, first + first_len, first_sum.begin());
+        add_digits(first_sum.data(), first_sum.size(), first, h);
+        std::copy(second + h, second + second_len, second_sum.begin());
+        add_digits(second_sum.data(), second_sum.size(), second, h);
+        std::vector<uint32_t> z1(first_sum.size() + second_sum.size());
+        mul_digits(z1.data(), first_sum.data(), first_sum.size(), second_sum.data(), second_sum.size());
+        sub_digits(z1.data(), z1.size(), z0.data(), z0.size());
+        sub_digits(z1.data(), z1.size(), z2.data(), z2.size());
+        std::copy(z0.begin(), z0.end(), result);
+        std::copy(z2.begin(), z2.end(), result + 2 * h);
+        add_digits(result + h, length - h, z1.data(), z1.size());
+    }
+
+    // Compares x[0, x_len) and y[0, y_len) as numbers.
+    int compare_digits(uint32_t const *x, size_t x_len, uint32_t const *y, size_t y_len) {
+        for (size_t i = std::max(x_len, y_len); i-- > 0;) {
+            uint32_t x_digit = i < x_len ? x[i] : 0;
+            uint32_t y_digit = i < y_len ? y[i] : 0;
+            if (x_digit != y_digit) {
+                return x_digit < y_digit ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    // result[0, max(x_len, y_len)) = |x - y|; returns whether x < y.
+    bool subtract_magnitude(uint32_t *result, uint32_t const *x, size_t x_len, uint32_t const *y, size_t y_len) {
+        size_t length = std::max(x_len, y_len);
+        bool negative = compare_digits(x, x_len, y, y_len) < 0;
+        if (negative) {
+            std::swap(x, y);
+            std::swap(x_len, y_len);
+        }
+        std::fill(result, result + length, 0);
+        std::copy(x, x + x_len, result);
+        sub_digits(result, length, y, y_len);
+        return negative;
+    }
+
+    // result[0, length) += value[0, value_len) * factor.
+    void add_mul_small(uint32_t *result, size_t length, uint32_t const *value, size_t value_len, uint32_t factor) {
+        uint64_t carry = 0;
+        size_t i = 0;
+        for (; i < value_len && i < length; i++) {
+            carry += result[i] + static_cast<uint64_t>(value[i]) * factor;
+            result[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+        for (; carry != 0 && i < length; i++) {
+            carry += result[i];
+            result[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+    }
+
+    // result[0, length) -= value[0, value_len) * factor for a product not
+    // above result.
+    void sub_mul_small(uint32_t *result, size_t length, uint32_t const *value, size_t value_len, uint32_t factor) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < length && (i < value_len || borrow != 0); i++) {
+            uint64_t product = (i < value_len ? static_cast<uint64_t>(value[i]) * factor : 0) + borrow;
+            auto low = static_cast<uint32_t>(product);
+            borrow = (product >> 32u) + (result[i] < low ? 1 : 0);
+            result[i] -= low;
+        }
+    }
+
+    void shift_right_one(uint32_t *value, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            value[i] = (value[i] >> 1u) | (i + 1 < length ? value[i + 1] << 31u : 0);
+        }
+    }
+
+    void divide_by_three(uint32_t *value, size_t length) {
+        uint64_t rest = 0;
+        for (size_t i = length; i-- > 0;) {
+            rest = (rest << 32u) | value[i];
+            value[i] = static_cast<uint32_t>(rest / 3);
+            rest %= 3;
+        }
+    }
+
+    // From r1 = p(1) and rm1 = p(-1), the latter as a magnitude and a sign,
+    // the sums of the even and of the odd coefficients of p, (r1 + rm1) / 2
+    // and (r1 - rm1) / 2, into length + 1 digits each.
+    void split_parity(uint32_t *even, uint32_t *odd, std::vector<uint32_t> const &r1,
+                      std::vector<uint32_t> const &rm1, bool negative) {
+        size_t length = r1.size();
+        uint32_t *sum = negative ? odd : even;
+        uint32_t *difference = negative ? even : odd;
+        std::fill(sum, sum + length + 1, 0);
+        std::copy(r1.begin(), r1.end(), sum);
+        add_digits(sum, length + 1, rm1.data(), rm1.size());
+        std::fill(difference, difference + length + 1, 0);
+        std::copy(r1.begin(), r1.end(), difference);
+        sub_digits(difference, length + 1, rm1.data(), rm1.size());
+        shift_right_one(sum, length + 1);
+        shift_right_one(difference, length + 1);
+    }
+
+    // Toom-32 for first_len about 1.5 times second_len: a = a0 + a1 x + a2 x^2
+    // and b = b0 + b1 x with x = B^h are evaluated at 0, 1, -1 and infinity,
+    // and the four coefficients of the product follow from
+    // c1 + c3 = (r1 - rm1) / 2 and c0 + c2 = (r1 + rm1) / 2. The result must
+    // come in zeroed.
+    void toom32(uint32_t *result, uint32_t const *first, size_t first_len,
+                uint32_t const *second, size_t second_len) {
+        size_t h = std::max((first_len + 2) / 3, (second_len + 1) / 2);
+        size_t length = first_len + second_len;
+        size_t top_len = first_len - 2 * h;
+        size_t high_len = second_len - h;
+        std::vector<uint32_t> first_one(h + 1);
+        std::vector<uint32_t> first_minus(h + 1);
+        std::copy(first, first + h, first_one.begin());
+        add_digits(first_one.data(), h + 1, first + 2 * h, top_len);
+        bool negative = subtract_magnitude(first_minus.data(), first_one.data(), h + 1, first + h, h);
+        add_digits(first_one.data(), h + 1, first + h, h);
+        std::vector<uint32_t> second_one(h + 1);
+        std::vector<uint32_t> second_minus(h);
+        std::copy(second, second + h, second_one.begin());
+        add_digits(second_one.data(), h + 1, second + h, high_len);
+        negative ^= subtract_magnitude(second_minus.data(), second, h, second + h, high_len);
+
+        std::vector<uint32_t> r1(2 * h + 2);
+        std::vector<uint32_t> rm1(2 * h + 2);
+        mul_digits(r1.data(), first_one.data(), h + 1, second_one.data(), h + 1);
+        mul_digits(rm1.data(), first_minus.data(), h + 1, second_minus.data(), h);
+        mul_digits(result, first, h, second, h);
+        mul_digits(result + 3 * h, first + 2 * h, top_len, second + h, high_len);
+
+        size_t n = r1.size() + 1;
+        std::vector<uint32_t> even(n);
+        std::vector<uint32_t> odd(n);
+        split_parity(even.data(), odd.data(), r1, rm1, negative);
+        sub_digits(even.data(), n, result, 2 * h);
+        sub_digits(odd.data(), n, result + 3 * h, length - 3 * h);
+        add_digits(result + h, length - h, odd.data(), n);
+        add_digits(result + 2 * h, length - 2 * h, even.data(), n);
+    }
+
+    // Toom-42 for first_len about twice second_len: a in four pieces and b in
+    // two, evaluated at 0, 1, -1, 2 and infinity. Besides the parity split,
+    // r2 - c0 - 4 c2 - 16 c4 = 2 c1 + 8 c3 separates c1 from c3 with one
+    // exact division by 3. The result must come in zeroed.
+    void toom42(uint32_t *result, uint32_t const *first, size_t first_len,
+                uint32_t const *second, size_t second_len) {
+        size_t h = std::max((first_len + 3) / 4, (second_len + 1) / 2);
+        size_t length = first_len + second_len;
+        size_t top_len = first_len - 3 * h;
+        size_t high_len = second_len - h;
+        std::vector<uint32_t> first_even(h + 1);
+        std::vector<uint32_t> first_odd(h + 1);
+        std::copy(first, first + h, first_even.begin());
+        add_digits(first_even.data(), h + 1, first + 2 * h, h);
+        std::copy(first + h, first + 2 * h, first_odd.begin());
+        add_digits(first_odd.data(), h + 1, first + 3 * h, top_len);
+        std::vector<uint32_t> first_minus(h + 1);
+        bool negative = subtract_magnitude(first_minus.data(), first_even.data(), h + 1, first_odd.data(), h + 1);
+        std::vector<uint32_t> first_one = first_even;
+        add_digits(first_one.data(), h + 1, first_odd.data(), h + 1);
+        std::vector<uint32_t> first_two(h + 1);
+        std::copy(first, first + h, first_two.begin());
+        add_mul_small(first_two.data(), h + 1, first + h, h, 2);
+        add_mul_small(first_two.data(), h + 1, first + 2 * h, h, 4);
+        add_mul_small(first_two.data(), h + 1, first + 3 * h, top_len, 8);
+        std::vector<uint32_t> second_one(h + 1);
+        std::vector<uint32_t> second_minus(h);
+        std::vector<uint32_t> second_two(h + 1);
+        std::copy(second, second + h, second_one.begin());
+        add_digits(second_one.data(), h + 1, second + h, high_len);
+        negative ^= subtract_magnitude(second_minus.data(), second, h, second + h, high_len);
+        std::copy(second, second + h, second_two.begin());
+        add_mul_small(second_two.data(), h + 1, second + h, high_len, 2);
+
+        std::vector<uint32_t> r1(2 * h + 2);
+        std::vector<uint32_t> rm1(2 * h + 2);
+        size_t n = r1.size() + 1;
+        std::vector<uint32_t> r2(n);
+        mul_digits(r1.data(), first_one.data(), h + 1, second_one.data(), h + 1);
+        mul_digits(rm1.data(), first_minus.data(), h + 1, second_minus.data(), h);
+        mul_digits(r2.data(), first_two.data(), h + 1, second_two.data(), h + 1);
+        mul_digits(result, first, h, second, h);
+        mul_digits(result + 4 * h, first + 3 * h, top_len, second + h, high_len);
+        uint32_t const *c0 = result;
+        uint32_t const *c4 = result + 4 * h;
+        size_t c4_len = length - 4 * h;
+
+        std::vector<uint32_t> even(n);
+        std::vector<uint32_t> odd(n);
+        split_parity(even.data(), odd.data(), r1, rm1, negative);
+        sub_digits(even.data(), n, c0, 2 * h);
+        sub_digits(even.data(), n, c4, c4_len);
+        sub_digits(r2.data(), n, c0, 2 * h);
+        sub_mul_small(r2.data(), n, even.data(), n, 4);
+        sub_mul_small(r2.data(), n, c4, c4_len, 16);
+        shift_right_one(r2.data(), n);
+        sub_digits(r2.data(), n, odd.data(), n);
+        divide_by_three(r2.data(), n);
+        sub_digits(odd.data(), n, r2.data(), n);
+        add_digits(result + h, length - h, odd.data(), n);
+        add_digits(result + 2 * h, length - 2 * h, even.data(), n);
+        add_digits(result + 3 * h, length - 3 * h, r2.data(), n);
+    }
+}
+
+// Full product into first_len + second_len digits. Short operands use the
+// schoolbook loop, operands within a quarter of each other Karatsuba, length
+// ratios around 3:2 and 2:1 Toom-32 and Toom-42, and an operand 2.5 times as
+// long as the other or more is cut into chunks of the shorter length, each
+// multiplied as a balanced product.
+void mul_digits(uint32_t *result, uint32_t const *first, size_t first_len,
+                uint32_t const *second, size_t second_len) {
+    if (first_len < second_len) {
+        std::swap(first, second);
+        std::swap(first_len, second_len);
+    }
+    size_t length = first_len + second_len;
+    std::fill(result, result + length, 0);
+    if (second_len < KARATSUBA_THRESHOLD) {
+        multiply_columns(result, first, first_len, second, second_len, 0, length);
+    } else if (second_len >= TOOM_THRESHOLD && 4 * first_len >= 5 * second_len && 4 * first_len < 7 * second_len) {
+        toom32(result, first, first_len, second, second_len);
+    } else if (second_len >= TOOM_THRESHOLD && 4 * first_len >= 7 * second_len && 2 * first_len < 5 * second_len) {
+        toom42(result, first, first_len, second, second_len);
+    } else if (2 * second_len > first_len) {
+        karatsuba(result, first, first_len, second, second_len);
+    } else {
+        std::vector<uint32_t> chunk(2 * second_len);
+        for (size_t offset = 0; offset < first_len; offset += second_len) {
+            size_t chunk_len = std::min(second_len, first_len - offset);
+            mul_digits(chunk.data(), first + offset, chunk_len, second, second_len);
+            add_digits(result + offset, length - offset, chunk.data(), chunk_len + second_len);
+        }
+    }
+}
+
+// The lowest n digits of first * second. Short products never form the
+// columns at or above n; once both truncated operands reach the Karatsuba
+// threshold the full product of the truncated operands is cheaper.
+void mul_low_digits(uint32_t *result, uint32_t const *first, size_t first_len,
+                    uint32_t const *second, size_t second_len, size_t n) {
+    first_len = std::min(first_len, n);
+    second_len = std::min(second_len, n);
+    if (std::min(first_len, second_len) >= KARATSUBA_THRESHOLD) {
+        std::vector<uint32_t> full(first_len + second_len);
+        mul_digits(full.data(), first, first_len, second, second_len);
+        std::fill(result, result + n, 0);
+        std::copy(full.begin(), full.begin() + std::min(n, full.size()), result);
+        return;
+    }
+    std::fill(result, result + n, 0);
+    multiply_columns(result, first, first_len, second, second_len, 0, n);
+}
+
+// Digits skip and above of first * second, i.e. the exact floor of the
+// product divided by 2^(32 * skip). Only the columns from skip - 2 upwards
+// are formed; the columns left out add less than k * 2^(32 * (k + 1)) for
+// k = skip - 2, so the truncated sum can be off only when that could carry
+// past the two guard digits, in which case the full product is taken. As for
+// low products, operands at the Karatsuba threshold go straight to the full
+// product.
+void mul_high_digits(uint32_t *result, uint32_t const *first, size_t first_len,
+                     uint32_t const *second, size_t second_len, size_t skip) {
+    size_t length = first_len + second_len;
+    if (skip >= length) {
+        return;
+    }
+    if (std::min(first_len, second_len) >= KARATSUBA_THRESHOLD) {
+        std::vector<uint32_t> full(length);
+        mul_digits(full.data(), first, first_len, second, second_len);
+        std::copy(full.begin() + skip, full.end(), result);
+        return;
+    }
+    size_t begin = skip > HIGH_GUARD_DIGITS ? skip - HIGH_GUARD_DIGITS : 0;
+    std::vector<uint32_t> columns(length - begin);
+    multiply_columns(columns.data(), first, first_len, second, second_len, begin, length);
+    if (begin != 0 && static_cast<uint64_t>(columns[skip - begin - 1]) + begin + 1 >= (1ull << 32u)) {
+        begin = 0;
+        columns.assign(length, 0);
+        multiply_columns(columns.data(), first, first_len, second, second_len, 0, length);
+    }
+    std::copy(columns.begin() + (skip - begin), columns.end(), result);
+}
+
+namespace {
+    size_t const DIVEXACT_NEWTON_THRESHOLD = 2 * KARATSUBA_THRESHOLD;
+
+    uint32_t inverse_digit(uint32_t digit) {
+        uint32_t inverse = digit;
+        for (int i = 0; i < 4; i++) {
+            inverse *= 2 - digit * inverse;
+        }
+        return inverse;
+    }
+
+    // n digits of the 2-adic inverse of the odd number b. If b * x = 1 + B^p * h
+    // then x - B^p * x * h is correct to 2p digits, so each step doubles the
+    // precision with two low products.
+    void inverse_digits(uint32_t *inverse, uint32_t const *b, size_t b_len, size_t n) {
+        inverse[0] = inverse_digit(b[0]);
+        for (size_t p = 1; p < n;) {
+            size_t next = std::min(2 * p, n);
+            std::vector<uint32_t> error(next);
+            mul_low_digits(error.data(), b, b_len, inverse, p, next);
+            std::vector<uint32_t> correction(next - p);
+            mul_low_digits(correction.data(), inverse, p, error.data() + p, next - p, next - p);
+            uint64_t carry = 1;
+            for (size_t i = 0; i < next - p; i++) {
+                carry += static_cast<uint32_t>(~correction[i]);
+                inverse[p + i] = static_cast<uint32_t>(carry);
+                carry >>= 32u;
+            }
+            p = next;
+        }
+    }
+}
+
+// Quotient of an exact division by an odd divisor, computed from the low
+// end: every quotient digit is the current low digit times b[0]^-1 mod B,
+// so there is no digit estimation and no correction step. Only the low
+// a_len - b_len + 1 digits of the dividend are ever touched. When both the
+// quotient and a divisor of comparable length are long, a Newton-lifted
+// inverse of b replaces the digit-by-digit loop.
+void divexact_digits(uint32_t *quotient, uint32_t const *a, size_t a_len, uint32_t const *b, size_t b_len) {
+    size_t n = a_len - b_len + 1;
+    if (n >= DIVEXACT_NEWTON_THRESHOLD && 2 * b_len >= n) {
+        std::vector<uint32_t> inverse(n);
+        inverse_digits(inverse.data(), b, b_len, n);
+        mul_low_digits(quotient, a, a_len, inverse.data(), n, n);
+        return;
+    }
+    std::vector<uint32_t> rest(a, a + n);
+    uint32_t inverse = inverse_digit(b[0]);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t digit = rest[i] * inverse;
+        quotient[i] = digit;
+        uint64_t carry = 0;
+        size_t j = 0;
+        for (; j < b_len && i + j < n; j++) {
+            uint64_t product = static_cast<uint64_t>(digit) * b[j] + carry;
+            auto low = static_cast<uint32_t>(product);
+            carry = (product >> 32u) + (rest[i + j] < low ? 1 : 0);
+            rest[i + j] -= low;
+        }
+        for (size_t k = i + j; carry != 0 && k < n; k++) {
+            bool borrow = carry > rest[k];
+            rest[k] = static_cast<uint32_t>(rest[k] - carry);
+            carry = borrow ? 1 : 0;
+        }
+    }
+}
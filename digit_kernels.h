@@ -0,0 +1,20 @@
+#ifndef DIGIT_KERNELS_H
+#define DIGIT_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+size_t const KARATSUBA_THRESHOLD = 40;
+
+void mul_digits(uint32_t *result, uint32_t const *first, size_t first_len,
+                uint32_t const *second, size_t second_len);
+
+void mul_low_digits(uint32_t *result, uint32_t const *first, size_t first_len,
+                    uint32_t const *second, size_t second_len, size_t n);
+
+void mul_high_digits(uint32_t *result, uint32_t const *first, size_t first_len,
+                     uint32_t const *second, size_t second_len, size_t skip);
+
+void divexact_digits(uint32_t *quotient, uint32_t const *a, size_t a_len, uint32_t const *b, size_t b_len);
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef FIXED_BASE_POWMOD_H
+#define FIXED_BASE_POWMOD_H
+
+#include "big_integer_limbs.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+// Lim-Lee comb for base^e mod m with a fixed base. An exponent of up to
+// exponent_bits bits is cut into `teeth` rows of a = ceil(bits / teeth) bits,
+// and each row into `columns` blocks of b = ceil(a / columns) bits. The table
+// holds, for every block and every subset of rows, the product of the base
+// raised to the bit positions picked out, so one exponentiation costs b - 1
+// squarings and at most b * columns multiplications. The table is immutable
+// after construction and power() only reads it, so an instance can be
+// shared between threads.
+template<class Context>
+class fixed_base_powmod {
+public:
+    typedef typename Context::residue residue;
+
+    fixed_base_powmod(std::shared_ptr<Context const> context, big_integer const &base, size_t exponent_bits,
+                      size_t teeth = 5, size_t columns = 4)
+            : ctx(std::move(context)), bits(exponent_bits), teeth(teeth), columns(columns) {
+        if (teeth == 0 || teeth > 16 || columns == 0) {
+            throw std::runtime_error("Comb needs between 1 and 16 teeth and at least one column");
+        }
+        row_bits = (std::max<size_t>(bits, 1) + teeth - 1) / teeth;
+        block_bits = (row_bits + columns - 1) / columns;
+        base_residue = ctx->to_residue(base);
+        size_t entries = size_t(1) << teeth;
+        table.assign(columns * entries, residue());
+        residue scratch;
+        std::vector<residue> row_powers(teeth);
+        row_powers[0] = base_residue;
+        for (size_t i = 1; i < teeth; i++) {
+            row_powers[i] = row_powers[i - 1];
+            for (size_t k = 0; k < row_bits; k++) {
+                ctx->multiply(row_powers[i], row_powers[i], row_powers[i], scratch);
+            }
+        }
+        for (size_t u = 1; u < entries; u++) {
+            size_t low = u & (0 - u);
+            size_t i = 0;
+            while ((size_t(1) << i) != low) {
+                i++;
+            }
+            if (u == low) {
+                table[u] = row_powers[i];
+            } else {
+                ctx->multiply(table[u], table[u ^ low], row_powers[i], scratch);
+            }
+        }
+        for (size_t j = 1; j < columns; j++) {
+            for (size_t u = 1; u < entries; u++) {
+                residue &entry = table[j * entries + u];
+                entry = table[(j - 1) * entries + u];
+                for (size_t k = 0; k < block_bits; k++) {
+                    ctx->multiply(entry, entry, entry, scratch);
+                }
+            }
+        }
+    }
+
+    Context const &context() const {
+        return *ctx;
+    }
+
+    big_integer power(big_integer const &exponent) const {
+        if (exponent < 0) {
+            throw std::runtime_error("Negative exponent");
+        }
+        std::vector<uint32_t> digits = big_integer_limbs::digits(exponent);
+        residue result;
+        residue scratch;
+        if (exponent.bit_length() > bits) {
+            ctx->power(result, base_residue, digits, scratch);
+            return ctx->from_residue(result);
+        }
+        size_t entries = size_t(1) << teeth;
+        bool started = false;
+        for (size_t k = block_bits; k-- > 0;) {
+            if (started) {
+                ctx->multiply(result, result, result, scratch);
+            }
+            for (size_t j = columns; j-- > 0;) {
+                size_t offset = j * block_bits + k;
+                if (offset >= row_bits) {
+                    continue;
+                }
+                size_t index = 0;
+                for (size_t i = 0; i < teeth; i++) {
+                    size_t position = i * row_bits + offset;
+                    size_t digit = position / 32;
+                    if (digit < digits.size() && ((digits[digit] >> (position % 32)) & 1u)) {
+                        index |= size_t(1) << i;
+                    }
+                }
+                if (index == 0) {
+                    continue;
+                }
+                if (started) {
+                    ctx->multiply(result, result, table[j * entries + index], scratch);
+                } else {
+                    result = table[j * entries + index];
+                    started = true;
+                }
+            }
+        }
+        if (!started) {
+            result = ctx->one();
+        }
+        return ctx->from_residue(result);
+    }
+
+private:
+    std::shared_ptr<Context const> ctx;
+    size_t bits;
+    size_t teeth;
+    size_t columns;
+    size_t row_bits;
+    size_t block_bits;
+    residue base_residue;
+    std::vector<residue> table;
+};
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef MODULAR_H
+#define MODULAR_H
+
+#include "big_integer_limbs.h"
+#include "number_theory.h"
+#include <stdexcept>
+
+// A residue kept in the representation of a shared reduction context
+// (montgomery_context or barrett_context); arithmetic never leaves reduced
+// form and reuses the value's own limb and scratch storage.
+template<class Context>
+class modular {
+public:
+    typedef typename Context::residue residue;
+
+    modular(std::shared_ptr<Context const> context, big_integer const &value)
+            : ctx(std::move(context)), digits(ctx->to_residue(value)) {
+    }
+
+    big_integer value() const {
+        return ctx->from_residue(digits);
+    }
+
+    Context const &context() const {
+        return *ctx;
+    }
+
+    modular operator-() const {
+        modular result = *this;
+        residue zero(ctx->size());
+        ctx->sub(result.digits, zero, digits);
+        return result;
+    }
+
+    modular &operator+=(modular const &second) {
+        check_context(second);
+        ctx->add(digits, digits, second.digits);
+        return *this;
+    }
+
+    modular &operator-=(modular const &second) {
+        check_context(second);
+        ctx->sub(digits, digits, second.digits);
+        return *this;
+    }
+
+    modular &operator*=(modular const &second) {
+        check_context(second);
+        ctx->multiply(digits, digits, second.digits, scratch);
+        return *this;
+    }
+
+    friend modular operator+(modular first, modular const &second) {
+        return first += second;
+    }
+
+    friend modular operator-(modular first, modular const &second) {
+        return first -= second;
+    }
+
+    friend modular operator*(modular first, modular const &second) {
+        return first *= second;
+    }
+
+    friend bool operator==(modular const &first, modular const &second) {
+        first.check_context(second);
+        return first.digits == second.digits;
+    }
+
+    friend bool operator!=(modular const &first, modular const &second) {
+        return !(first == second);
+    }
+
+    modular inverse() const {
+        return modular(ctx, mod_inverse(value(), ctx->modulus()));
+    }
+
+    modular pow(big_integer const &exponent) const {
+        if (exponent < 0) {
+            return inverse().pow(-exponent);
+        }
+        modular result = *this;
+        ctx->power(result.digits, digits, big_integer_limbs::digits(exponent), result.scratch);
+        return result;
+    }
+
+private:
+    std::shared_ptr<Context const> ctx;
+    residue digits;
+    residue scratch;
+
+    void check_context(modular const &second) const {
+        if (ctx != second.ctx) {
+            throw std::runtime_error("Modular operands use different contexts");
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "montgomery.h"
+#include <stdexcept>
+
+montgomery_context::montgomery_context(big_integer const &modulus) {
+    if (modulus < 0 || (modulus.to_uint64() & 1u) == 0 || modulus == 1) {
+        throw std::runtime_error("Montgomery modulus must be odd and greater than one");
+    }
+    mod = modulus;
+    mod_digits = big_integer_limbs::digits(modulus);
+    uint32_t inverse = mod_digits[0];
+    for (int i = 0; i < 4; i++) {
+        inverse *= 2 - mod_digits[0] * inverse;
+    }
+    mod_inverse = 0u - inverse;
+    r_squared = big_integer_limbs::digits((big_integer(1) << static_cast<int>(64 * size())) % modulus);
+    r_squared.resize(size());
+    residue scratch;
+    to_montgomery(unit, 1, scratch);
+}
+
+montgomery_context::residue montgomery_context::to_montgomery(big_integer const &value) const {
+    residue result = reduced_digits(value);
+    residue scratch;
+    multiply(result, result, r_squared, scratch);
+    return result;
+}
+
+void montgomery_context::to_montgomery(residue &result, uint32_t value, residue &scratch) const {
+    result.assign(size(), 0);
+    result[0] = value;
+    if (size() == 1) {
+        result[0] %= mod_digits[0];
+    }
+    multiply(result, result, r_squared, scratch);
+}
+
+big_integer montgomery_context::from_montgomery(residue const &value) const {
+    residue plain(size()), scratch;
+    plain[0] = 1;
+    multiply(plain, value, plain, scratch);
+    return big_integer_limbs::from_digits(plain);
+}
+
+montgomery_context::residue montgomery_context::to_residue(big_integer const &value) const {
+    return to_montgomery(value);
+}
+
+big_integer montgomery_context::from_residue(residue const &value) const {
+    return from_montgomery(value);
+}
+
+void montgomery_context::halve(residue &value) const {
+    uint64_t carry = 0;
+    if (value[0] & 1u) {
+        for (size_t i = 0; i < size(); i++) {
+            carry += static_cast<uint64_t>(value[i]) + mod_digits[i];
+            value[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+    }
+    for (size_t i = 0; i < size(); i++) {
+        uint32_t high = i + 1 < size() ? value[i + 1] : static_cast<uint32_t>(carry);
+        value[i] = (value[i] >> 1u) | (high << 31u);
+    }
+}
+
+// Coarsely integrated operand scanning: one row of the product and one row
+// of the reduction per digit of the second operand, in n + 2 digits of scratch.
+void montgomery_context::multiply(residue &result, residue const &first, residue const &second,
+                                  residue &scratch) const {
+    size_t n = size();
+    scratch.assign(n + 2, 0);
+    uint32_t *t = scratch.data();
+    for (size_t i = 0; i < n; i++) {
+        uint64_t carry = 0;
+        uint64_t digit = second[i];
+        for (size_t j = 0; j < n; j++) {
+            carry += t[j] + first[j] * digit;
+            t[j] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+        carry += t[n];
+        t[n] = static_cast<uint32_t>(carry);
+        t[n + 1] = static_cast<uint32_t>(carry >> 32u);
+        uint64_t m = static_cast<uint32_t>(t[0] * mod_inverse);
+        carry = (t[0] + m * mod_digits[0]) >> 32u;
+        for (size_t j = 1; j < n; j++) {
+            carry += t[j] + m * mod_digits[j];
+            t[j - 1] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+        carry += t[n];
+        t[n - 1] = static_cast<uint32_t>(carry);
+        t[n] = t[n + 1] + static_cast<uint32_t>(carry >> 32u);
+    }
+    if (!less_than_modulus(t, t[n])) {
+        subtract_modulus(t);
+    }
+    result.assign(t, t + n);
+}
+
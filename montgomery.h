@@ -0,0 +1,29 @@
+#ifndef MONTGOMERY_H
+#define MONTGOMERY_H
+
+#include "residue_context.h"
+
+class montgomery_context : public residue_context<montgomery_context> {
+public:
+    explicit montgomery_context(big_integer const &modulus);
+
+    residue to_montgomery(big_integer const &value) const;
+
+    void to_montgomery(residue &result, uint32_t value, residue &scratch) const;
+
+    big_integer from_montgomery(residue const &value) const;
+
+    residue to_residue(big_integer const &value) const;
+
+    big_integer from_residue(residue const &value) const;
+
+    void halve(residue &value) const;
+
+    void multiply(residue &result, residue const &first, residue const &second, residue &scratch) const;
+
+private:
+    uint32_t mod_inverse;
+    residue r_squared;
+};
+
+#endif
@@ -0,0 +1,860 @@
+#include "number_theory.h"
+#include "barrett.h"
+#include "big_integer_limbs.h"
+#include "modular.h"
+#include "montgomery.h"
+#include "parallel.h"
+#include "pseudo_mersenne.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+    __extension__ typedef unsigned __int128 uint128_t;
+
+    typedef montgomery_context::residue residue;
+
+    uint32_t const TRIAL_DIVISION_LIMIT = 1000;
+
+    uint32_t const SIEVE_LIMIT = 1u << 16u;
+
+    size_t const SIEVE_WINDOW = 1u << 12u;
+
+    uint32_t const SMALL_MULTINOMIAL_RATIO = 1000;
+
+    uint32_t const PRIME_CACHE_LIMIT = 1u << 24u;
+
+    struct small_primes {
+        std::vector<uint32_t> primes;
+        std::vector<std::pair<word_divisor, size_t>> groups;
+        size_t trial_groups = 0;
+
+        small_primes() {
+            std::vector<bool> composite(SIEVE_LIMIT);
+            for (uint32_t i = 2; i < SIEVE_LIMIT; i++) {
+                if (!composite[i]) {
+                    primes.push_back(i);
+                    for (uint32_t j = i * i; j < SIEVE_LIMIT; j += i) {
+                        composite[j] = true;
+                    }
+                }
+            }
+            uint64_t product = 1;
+            for (size_t i = 0; i < primes.size(); i++) {
+                if (product * primes[i] > 0xFFFFFFFFull || (primes[i] > TRIAL_DIVISION_LIMIT && trial_groups == 0)) {
+                    groups.emplace_back(word_divisor(product), i);
+                    product = 1;
+                    if (primes[i] > TRIAL_DIVISION_LIMIT) {
+                        trial_groups = groups.size();
+                    }
+                }
+                product *= primes[i];
+            }
+            groups.emplace_back(word_divisor(product), primes.size());
+        }
+    };
+
+    small_primes const SMALL_PRIMES;
+
+    uint64_t mul_mod(uint64_t first, uint64_t second, uint64_t mod) {
+        return static_cast<uint64_t>(static_cast<uint128_t>(first) * second % mod);
+    }
+
+    bool miller_rabin(uint64_t n, uint64_t base) {
+        uint64_t d = n - 1;
+        int s = 0;
+        while ((d & 1u) == 0) {
+            d >>= 1u;
+            s++;
+        }
+        uint64_t x = 1;
+        for (base %= n; d > 0; d >>= 1u) {
+            if (d & 1u) {
+                x = mul_mod(x, base, n);
+            }
+            base = mul_mod(base, base, n);
+        }
+        if (x == 1 || x == n - 1) {
+            return true;
+        }
+        for (int r = 1; r < s; r++) {
+            x = mul_mod(x, x, n);
+            if (x == n - 1) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The first twelve prime bases are a deterministic witness set below 2^64.
+    bool is_prime(uint64_t n) {
+        for (uint32_t p : SMALL_PRIMES.primes) {
+            if (p > TRIAL_DIVISION_LIMIT) {
+                break;
+            }
+            if (n % p == 0) {
+                return n == p;
+            }
+            if (static_cast<uint64_t>(p) * p > n) {
+                return true;
+            }
+        }
+        for (size_t i = 0; i < 12; i++) {
+            if (!miller_rabin(n, SMALL_PRIMES.primes[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int jacobi(uint32_t a, uint32_t n) {
+        int result = 1;
+        for (a %= n; a != 0; a %= n) {
+            while ((a & 1u) == 0) {
+                a >>= 1u;
+                if (n % 8 == 3 || n % 8 == 5) {
+                    result = -result;
+                }
+            }
+            std::swap(a, n);
+            if (a % 4 == 3 && n % 4 == 3) {
+                result = -result;
+            }
+        }
+        return n == 1 ? result : 0;
+    }
+
+    std::vector<uint32_t> sieve_primes(uint32_t n) {
+        std::vector<uint32_t> result;
+        std::vector<bool> composite(static_cast<size_t>(n) + 1);
+        for (uint64_t i = 2; i <= n; i++) {
+            if (!composite[i]) {
+                result.push_back(static_cast<uint32_t>(i));
+                for (uint64_t j = i * i; j <= n; j += i) {
+                    composite[j] = true;
+                }
+            }
+        }
+        return result;
+    }
+
+    // All primes up to at least n. Up to PRIME_CACHE_LIMIT the table is kept
+    // between calls and only sieved again, to twice the old bound, when a
+    // larger n is asked for; larger requests get a table of their own that is
+    // not kept. Callers stop at their own bound.
+    std::shared_ptr<std::vector<uint32_t> const> primes_up_to(uint32_t n) {
+        if (n > PRIME_CACHE_LIMIT) {
+            return std::make_shared<std::vector<uint32_t> const>(sieve_primes(n));
+        }
+        static std::mutex mutex;
+        static std::shared_ptr<std::vector<uint32_t> const> table;
+        static uint32_t bound = 0;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!table || bound < n) {
+            bound = std::min(std::max(n, 2 * bound), PRIME_CACHE_LIMIT);
+            table = std::make_shared<std::vector<uint32_t> const>(sieve_primes(bound));
+        }
+        return table;
+    }
+
+    // Word-size factors are packed into 64-bit leaves before the balanced
+    // product tree takes over.
+    big_integer product_tree(std::vector<uint64_t> const &factors) {
+        std::vector<uint64_t> packed;
+        for (uint64_t factor : factors) {
+            if (!packed.empty() && (packed.back() >> 32u) == 0 && (factor >> 32u) == 0) {
+                packed.back() *= factor;
+            } else {
+                packed.push_back(factor);
+            }
+        }
+        std::vector<big_integer> leaves;
+        leaves.reserve(packed.size());
+        for (uint64_t leaf : packed) {
+            leaves.push_back(big_integer::from_uint64(leaf));
+        }
+        return product(leaves);
+    }
+
+    // Odd part of the prime swing n! / ((n / 2)!)^2, as a product of prime powers.
+    big_integer odd_swing(uint32_t n, std::vector<uint32_t> const &primes) {
+        std::vector<uint64_t> factors;
+        uint32_t root = static_cast<uint32_t>(std::sqrt(static_cast<double>(n)));
+        for (size_t i = 1; i < primes.size() && primes[i] <= n; i++) {
+            uint32_t p = primes[i];
+            if (p > n / 2) {
+                factors.push_back(p);
+            } else if (p <= n / 3 && p > root) {
+                if ((n / p) & 1u) {
+                    factors.push_back(p);
+                }
+            } else if (p <= root) {
+                uint64_t power = 1;
+                for (uint32_t q = n / p; q > 0; q /= p) {
+                    if (q & 1u) {
+                        power *= p;
+                    }
+                }
+                if (power > 1) {
+                    factors.push_back(power);
+                }
+            }
+        }
+        return product_tree(factors);
+    }
+
+    uint32_t legendre(uint32_t n, uint32_t p) {
+        uint32_t result = 0;
+        for (uint32_t q = n / p; q > 0; q /= p) {
+            result += q;
+        }
+        return result;
+    }
+
+    void push_power(std::vector<uint64_t> &factors, uint32_t p, uint32_t exp) {
+        uint64_t power = 1;
+        for (; exp > 0; exp--) {
+            if (power * p > 0xFFFFFFFFull) {
+                factors.push_back(power);
+                power = 1;
+            }
+            power *= p;
+        }
+        if (power > 1) {
+            factors.push_back(power);
+        }
+    }
+
+    big_integer odd_factorial(uint32_t n, std::vector<uint32_t> const &primes) {
+        if (n < 3) {
+            return 1;
+        }
+        big_integer half = odd_factorial(n / 2, primes);
+        return half * half * odd_swing(n, primes);
+    }
+
+    bool is_zero(residue const &value) {
+        return std::all_of(value.begin(), value.end(), [](uint32_t digit) { return digit == 0; });
+    }
+
+    // Strong Lucas test with P = 1 on n + 1 = d * 2^s, evaluated in Montgomery
+    // form with the doubling formulas U(2k) = U(k)V(k), V(2k) = V(k)^2 - 2Q^k.
+    bool strong_lucas_test(montgomery_context const &context, std::vector<uint32_t> const &d, size_t s,
+                      residue const &disc, residue const &q) {
+        residue u = context.one(), v = context.one(), qk = q, tmp, scratch;
+        size_t top = d.size() * 32 - 1;
+        while ((d[top / 32] & (1u << (top % 32))) == 0) {
+            top--;
+        }
+        for (size_t i = top; i-- > 0;) {
+            context.multiply(u, u, v, scratch);
+            context.multiply(v, v, v, scratch);
+            context.sub(v, v, qk);
+            context.sub(v, v, qk);
+            context.multiply(qk, qk, qk, scratch);
+            if (d[i / 32] & (1u << (i % 32))) {
+                context.multiply(tmp, disc, u, scratch);
+                context.add(u, u, v);
+                context.halve(u);
+                context.add(v, v, tmp);
+                context.halve(v);
+                context.multiply(qk, qk, q, scratch);
+            }
+        }
+        if (is_zero(u) || is_zero(v)) {
+            return true;
+        }
+        for (size_t r = 1; r < s; r++) {
+            context.multiply(v, v, v, scratch);
+            context.sub(v, v, qk);
+            context.sub(v, v, qk);
+            if (is_zero(v)) {
+                return true;
+            }
+            context.multiply(qk, qk, qk, scratch);
+        }
+        return false;
+    }
+}
+
+bool is_probable_prime(big_integer const &n, int rounds, bool strong_lucas) {
+    if (n < 0 || n.bit_length() < 2) {
+        return false;
+    }
+    if (n.bit_length() <= 64) {
+        return is_prime(n.to_uint64());
+    }
+    size_t begin = 0;
+    for (size_t g = 0; g < SMALL_PRIMES.trial_groups; g++) {
+        uint64_t r = n.mod_u64(SMALL_PRIMES.groups[g].first);
+        for (size_t i = begin; i < SMALL_PRIMES.groups[g].second; i++) {
+            if (r % SMALL_PRIMES.primes[i] == 0) {
+                return false;
+            }
+        }
+        begin = SMALL_PRIMES.groups[g].second;
+    }
+
+    montgomery_context context(n);
+    big_integer n_minus_one = n - 1;
+    size_t s = n_minus_one.trailing_zeros();
+    std::vector<uint32_t> d = big_integer_limbs::digits(n_minus_one >> static_cast<int>(s));
+    residue minus_one = context.to_montgomery(n_minus_one), base, x, scratch;
+    base.reserve(context.size());
+    x.reserve(context.size());
+    scratch.reserve(context.size() + 2);
+    size_t bases = std::min(static_cast<size_t>(std::max(rounds, 1)), SMALL_PRIMES.primes.size());
+    for (size_t i = 0; i < bases; i++) {
+        context.to_montgomery(base, SMALL_PRIMES.primes[i], scratch);
+        context.power(x, base, d, scratch);
+        if (x == context.one() || x == minus_one) {
+            continue;
+        }
+        bool witness = true;
+        for (size_t r = 1; r < s && witness; r++) {
+            context.multiply(x, x, x, scratch);
+            witness = x != minus_one;
+        }
+        if (witness) {
+            return false;
+        }
+    }
+    if (!strong_lucas) {
+        return true;
+    }
+
+    auto low = static_cast<uint32_t>(n.to_uint64());
+    int disc = 5;
+    for (;; disc = disc > 0 ? -disc - 2 : -disc + 2) {
+        auto a = static_cast<uint32_t>(std::abs(disc));
+        int symbol = jacobi(n.mod_u32(a), a);
+        if (a % 4 == 3 && low % 4 == 3) {
+            symbol = -symbol;
+        }
+        if (disc < 0 && low % 4 == 3) {
+            symbol = -symbol;
+        }
+        if (symbol == -1) {
+            break;
+        }
+        if (symbol == 0) {
+            return false;
+        }
+        if (disc == 13 && is_perfect_square(n)) {
+            return false;
+        }
+    }
+    big_integer n_plus_one = n + 1;
+    size_t lucas_s = n_plus_one.trailing_zeros();
+    return strong_lucas_test(context, big_integer_limbs::digits(n_plus_one >> static_cast<int>(lucas_s)), lucas_s,
+                             context.to_montgomery(disc), context.to_montgomery((1 - disc) / 4));
+}
+
+big_integer next_prime(big_integer const &n) {
+    prime_generator generator(n + 1);
+    big_integer result;
+    generator.next(result);
+    return result;
+}
+
+// 2^p - 1 is prime iff s_(p-2) = 0 for s_0 = 4, s_(k+1) = s_k^2 - 2, with
+// every step reduced by folding instead of dividing.
+bool lucas_lehmer(uint32_t p) {
+    if (p == 2) {
+        return true;
+    }
+    if (!is_prime(p)) {
+        return false;
+    }
+    typedef modular<pseudo_mersenne_context> element;
+    std::shared_ptr<pseudo_mersenne_context const> context = std::make_shared<pseudo_mersenne_context>(p, 1);
+    element s(context, 4);
+    element two(context, 2);
+    for (uint32_t i = 0; i < p - 2; i++) {
+        s *= s;
+        s -= two;
+    }
+    return s.value() == 0;
+}
+
+prime_generator::prime_generator(big_integer const &begin) : prime_generator(begin, 0) {
+    bounded = false;
+    pending_two = begin <= 2;
+}
+
+prime_generator::prime_generator(big_integer const &begin, big_integer const &end)
+        : base(begin), end(end), bounded(true), position(0) {
+    pending_two = base <= 2 && end > 2;
+    if (base < 3) {
+        base = 3;
+    } else if ((base.to_uint64() & 1u) == 0) {
+        base += 1;
+    }
+    uint64_t limit = std::min(static_cast<uint64_t>(SIEVE_LIMIT), 64 * static_cast<uint64_t>(base.bit_length()));
+    size_t begin_index = 0;
+    for (auto const &group : SMALL_PRIMES.groups) {
+        if (SMALL_PRIMES.primes[begin_index] > limit) {
+            break;
+        }
+        uint64_t r = base.mod_u64(group.first);
+        for (size_t i = begin_index; i < group.second; i++) {
+            remainders.push_back(static_cast<uint32_t>(r % SMALL_PRIMES.primes[i]));
+        }
+        begin_index = group.second;
+    }
+    sieve();
+}
+
+// Marks the odd candidates base + 2i, 0 <= i < SIEVE_WINDOW, that have a
+// small prime factor, using the stored remainders of base. The number of
+// sieving primes grows with the size of the candidates, up to SIEVE_LIMIT.
+void prime_generator::sieve() {
+    composite.assign(SIEVE_WINDOW, false);
+    uint64_t small_base = base.bit_length() <= 32 ? base.to_uint64() : SIEVE_LIMIT;
+    for (size_t k = 1; k < remainders.size(); k++) {
+        uint64_t p = SMALL_PRIMES.primes[k];
+        uint64_t i = (p - remainders[k]) % p * ((p + 1) / 2) % p;
+        if (small_base + 2 * i == p) {
+            i += p;
+        }
+        for (; i < SIEVE_WINDOW; i += p) {
+            composite[i] = true;
+        }
+    }
+}
+
+bool prime_generator::next(big_integer &prime) {
+    if (pending_two) {
+        pending_two = false;
+        prime = 2;
+        return true;
+    }
+    while (!bounded || base < end) {
+        for (; position < SIEVE_WINDOW; position++) {
+            if (composite[position]) {
+                continue;
+            }
+            big_integer candidate = base + static_cast<int>(2 * position);
+            if (bounded && candidate >= end) {
+                return false;
+            }
+            if (is_probable_prime(candidate)) {
+                prime = candidate;
+                position++;
+                return true;
+            }
+        }
+        base += static_cast<int>(2 * SIEVE_WINDOW);
+        for (size_t k = 0; k < remainders.size(); k++) {
+            remainders[k] = static_cast<uint32_t>((remainders[k] + 2 * SIEVE_WINDOW) % SMALL_PRIMES.primes[k]);
+        }
+        position = 0;
+        sieve();
+    }
+    return false;
+}
+
+big_integer gcd(big_integer first, big_integer second) {
+    if (first < 0) {
+        first = -first;
+    }
+    if (second < 0) {
+        second = -second;
+    }
+    while (second != 0) {
+        first %= second;
+        std::swap(first, second);
+    }
+    return first;
+}
+
+big_integer mod_inverse(big_integer const &value, big_integer const &modulus) {
+    if (modulus <= 0) {
+        throw std::runtime_error("Modulus must be positive");
+    }
+    big_integer r0 = modulus;
+    big_integer r1 = value % modulus;
+    if (r1 < 0) {
+        r1 += modulus;
+    }
+    big_integer t0 = 0;
+    big_integer t1 = 1;
+    while (r1 != 0) {
+        big_integer q = r0 / r1;
+        r0 -= q * r1;
+        std::swap(r0, r1);
+        t0 -= q * t1;
+        std::swap(t0, t1);
+    }
+    if (r0 != 1) {
+        throw std::runtime_error("Value is not invertible");
+    }
+    if (t0 < 0) {
+        t0 += modulus;
+    }
+    return t0;
+}
+
+// Montgomery's simultaneous inversion: one extended Euclidean inversion of the
+// product of all values, then two multiplications per value to peel the
+// prefix products back off.
+void batch_invert(std::vector<big_integer> &values, big_integer const &modulus) {
+    if (values.empty()) {
+        return;
+    }
+    if (modulus <= 1) {
+        throw std::runtime_error("Modulus must be greater than one");
+    }
+    typedef modular<barrett_context> element;
+    std::shared_ptr<barrett_context const> context = std::make_shared<barrett_context>(modulus);
+    std::vector<element> elements;
+    std::vector<element> prefix;
+    elements.reserve(values.size());
+    prefix.reserve(values.size());
+    for (big_integer const &value : values) {
+        elements.emplace_back(context, value);
+        prefix.push_back(prefix.empty() ? elements.back() : prefix.back() * elements.back());
+    }
+    element inverse = prefix.back().inverse();
+    for (size_t i = values.size(); i-- > 1;) {
+        values[i] = (inverse * prefix[i - 1]).value();
+        inverse *= elements[i];
+    }
+    values[0] = inverse.value();
+}
+
+namespace {
+    uint32_t window_at(std::vector<uint32_t> const &digits, size_t position, size_t width) {
+        uint32_t result = 0;
+        for (size_t i = width; i-- > 0;) {
+            size_t bit = position + i;
+            size_t digit = bit / 32;
+            result = (result << 1u) | (digit < digits.size() ? (digits[digit] >> (bit % 32)) & 1u : 0);
+        }
+        return result;
+    }
+
+    // Straus' interleaving: every base gets its own table of window powers,
+    // the squarings of the single accumulator are shared, and each exponent
+    // contributes one table multiplication per window.
+    template<class Context>
+    big_integer multi_power(Context const &context, std::vector<big_integer> const &bases,
+                            std::vector<std::vector<uint32_t>> const &exponents, size_t bits) {
+        typedef typename Context::residue residue;
+        size_t window = bits <= 64 ? 3 : bits <= 512 ? 4 : 5;
+        size_t entries = size_t(1) << window;
+        residue scratch;
+        std::vector<std::vector<residue>> tables(bases.size(), std::vector<residue>(entries));
+        for (size_t i = 0; i < bases.size(); i++) {
+            tables[i][1] = context.to_residue(bases[i]);
+            for (size_t d = 2; d < entries; d++) {
+                context.multiply(tables[i][d], tables[i][d - 1], tables[i][1], scratch);
+            }
+        }
+        residue result = context.one();
+        bool started = false;
+        for (size_t k = (bits + window - 1) / window * window; k-- > 0;) {
+            if (started) {
+                context.multiply(result, result, result, scratch);
+            }
+            if (k % window != 0) {
+                continue;
+            }
+            for (size_t i = 0; i < bases.size(); i++) {
+                uint32_t d = window_at(exponents[i], k, window);
+                if (d != 0) {
+                    context.multiply(result, result, tables[i][d], scratch);
+                    started = true;
+                }
+            }
+        }
+        return context.from_residue(result);
+    }
+}
+
+// Product of base_i^exp_i modulo modulus; negative exponents invert their
+// base first.
+big_integer multi_powmod(std::vector<std::pair<big_integer, big_integer>> const &terms, big_integer const &modulus) {
+    if (modulus <= 0) {
+        throw std::runtime_error("Modulus must be positive");
+    }
+    if (modulus == 1) {
+        return 0;
+    }
+    std::vector<big_integer> bases;
+    std::vector<std::vector<uint32_t>> exponents;
+    size_t bits = 0;
+    for (auto const &term : terms) {
+        bool negative = term.second < 0;
+        bases.push_back(negative ? mod_inverse(term.first, modulus) : term.first);
+        big_integer exponent = negative ? -term.second : term.second;
+        exponents.push_back(big_integer_limbs::digits(exponent));
+        bits = std::max(bits, exponent.bit_length());
+    }
+    if (modulus.to_uint64() & 1u) {
+        return multi_power(montgomery_context(modulus), bases, exponents, bits);
+    }
+    return multi_power(barrett_context(modulus), bases, exponents, bits);
+}
+
+namespace {
+    bool worth_threads(std::vector<std::vector<big_integer>> const &levels) {
+        return levels.back()[0].bit_length() >= PARALLEL_MIN_BITS;
+    }
+
+    // The root of the subproduct tree is pushed down modulo the squares of the
+    // nodes, which leaves P mod N_i^2 at leaf i; dividing by N_i gives
+    // (P / N_i) mod N_i. Every node only reads its parent and its own tree
+    // node, so each level is processed in parallel.
+    std::vector<big_integer> cofactor_remainders(std::vector<std::vector<big_integer>> const &levels) {
+        bool parallel = worth_threads(levels);
+        std::vector<big_integer> remainders = levels.back();
+        for (size_t level = levels.size() - 1; level-- > 0;) {
+            std::vector<big_integer> below(levels[level].size());
+            parallel_for(below.size(), parallel, [&](size_t i) {
+                below[i] = divrem(remainders[i / 2], levels[level][i] * levels[level][i]).second;
+            });
+            remainders.swap(below);
+        }
+        parallel_for(remainders.size(), parallel, [&](size_t i) {
+            remainders[i] = divexact(remainders[i], levels[0][i]);
+        });
+        return remainders;
+    }
+}
+
+std::vector<big_integer> batch_gcd(std::vector<big_integer> const &moduli) {
+    if (moduli.empty()) {
+        return {};
+    }
+    std::vector<std::vector<big_integer>> tree = subproduct_tree(moduli);
+    std::vector<big_integer> result = cofactor_remainders(tree);
+    parallel_for(result.size(), worth_threads(tree), [&](size_t i) {
+        result[i] = gcd(result[i], moduli[i]);
+    });
+    return result;
+}
+
+crt_basis::crt_basis(std::vector<big_integer> const &moduli) {
+    if (moduli.empty()) {
+        throw std::runtime_error("CRT basis needs at least one modulus");
+    }
+    for (big_integer const &m : moduli) {
+        if (m <= 0) {
+            throw std::runtime_error("Modulus must be positive");
+        }
+    }
+    tree = subproduct_tree(moduli);
+    std::vector<big_integer> cofactors = cofactor_remainders(tree);
+    inverses.reserve(moduli.size());
+    for (size_t i = 0; i < moduli.size(); ++i) {
+        if (gcd(cofactors[i], moduli[i]) != 1) {
+            throw std::runtime_error("CRT moduli are not pairwise coprime");
+        }
+        inverses.push_back(mod_inverse(cofactors[i], moduli[i]));
+    }
+}
+
+big_integer const &crt_basis::modulus() const {
+    return tree.back()[0];
+}
+
+size_t crt_basis::size() const {
+    return tree[0].size();
+}
+
+// Each leaf holds r_i * (M / m_i)^-1 mod m_i; a node combines its children
+// as left * right_product + right * left_product, which yields
+// sum r_i * (M / m_i)^-1 * (M / m_i) at the root.
+big_integer crt_basis::reconstruct(std::vector<big_integer> const &residues) const {
+    if (residues.size() != size()) {
+        throw std::runtime_error("Residue count does not match CRT basis");
+    }
+    std::vector<big_integer> values;
+    values.reserve(residues.size());
+    for (size_t i = 0; i < residues.size(); ++i) {
+        big_integer value = residues[i] * inverses[i] % tree[0][i];
+        if (value < 0) {
+            value += tree[0][i];
+        }
+        values.push_back(value);
+    }
+    for (size_t level = 0; level + 1 < tree.size(); ++level) {
+        std::vector<big_integer> above;
+        above.reserve(tree[level + 1].size());
+        for (size_t i = 0; i + 1 < values.size(); i += 2) {
+            above.push_back(values[i] * tree[level][i + 1] + values[i + 1] * tree[level][i]);
+        }
+        if (values.size() % 2 == 1) {
+            above.push_back(values.back());
+        }
+        values.swap(above);
+    }
+    return values[0] % modulus();
+}
+
+// Luschny's prime swing: n! = ((n / 2)!)^2 * swing(n), with the power of two
+// split off and applied as a single shift at the end.
+big_integer factorial(uint32_t n) {
+    uint32_t ones = 0;
+    for (uint32_t bits = n; bits != 0; bits >>= 1u) {
+        ones += bits & 1u;
+    }
+    return odd_factorial(n, *primes_up_to(n)) << static_cast<int>(n - ones);
+}
+
+namespace {
+    // A multinomial whose largest part m leaves only a few factors: the rising
+    // product (m + 1) ... n comes from a product tree and is divided exactly by
+    // the factorials of the other parts, so nothing is sieved up to n.
+    big_integer small_multinomial(uint32_t n, uint32_t m, std::vector<uint32_t> const &ks) {
+        std::vector<uint64_t> factors;
+        for (uint64_t i = static_cast<uint64_t>(m) + 1; i <= n; i++) {
+            factors.push_back(i);
+        }
+        std::vector<big_integer> denominators;
+        for (uint32_t k : ks) {
+            if (k > 1) {
+                denominators.push_back(factorial(k));
+            }
+        }
+        return divexact(product_tree(factors), product(denominators));
+    }
+
+    bool few_factors(uint32_t n, uint32_t rest) {
+        return rest <= n / SMALL_MULTINOMIAL_RATIO;
+    }
+}
+
+// The exponent of every prime p <= n in C(n, k) is the number of borrows when
+// subtracting k from n in base p (Kummer), so the result is assembled from
+// prime powers without forming any factorial. For k small against n the
+// quotient of n ... (n - k + 1) by k! is cheaper than a sieve up to n.
+big_integer binomial(uint32_t n, uint32_t k) {
+    if (k > n) {
+        return 0;
+    }
+    k = std::min(k, n - k);
+    if (few_factors(n, k)) {
+        return small_multinomial(n, n - k, {k});
+    }
+    std::vector<uint64_t> factors;
+    for (uint32_t p : *primes_up_to(n)) {
+        if (p > n) {
+            break;
+        } else if (p > n - k) {
+            factors.push_back(p);
+        } else if (p > n / 2) {
+            continue;
+        } else {
+            push_power(factors, p, legendre(n, p) - legendre(k, p) - legendre(n - k, p));
+        }
+    }
+    return product_tree(factors);
+}
+
+big_integer multinomial(std::vector<uint32_t> const &ks) {
+    uint32_t n = 0;
+    size_t largest = 0;
+    for (size_t i = 0; i < ks.size(); i++) {
+        if (n + ks[i] < n) {
+            throw std::runtime_error("Multinomial total is too large");
+        }
+        n += ks[i];
+        if (ks[i] > ks[largest]) {
+            largest = i;
+        }
+    }
+    if (!ks.empty() && few_factors(n, n - ks[largest])) {
+        std::vector<uint32_t> rest = ks;
+        rest.erase(rest.begin() + static_cast<std::ptrdiff_t>(largest));
+        return small_multinomial(n, ks[largest], rest);
+    }
+    std::vector<uint64_t> factors;
+    for (uint32_t p : *primes_up_to(n)) {
+        if (p > n) {
+            break;
+        }
+        uint32_t exp = legendre(n, p);
+        for (uint32_t k : ks) {
+            exp -= legendre(k, p);
+        }
+        push_power(factors, p, exp);
+    }
+    return product_tree(factors);
+}
+
+// Fast doubling with three squarings per bit:
+// F(2k + 1) = F(k)^2 + F(k + 1)^2, F(2k) = (F(k) + F(k + 1))^2 - 2F(k)^2 - F(k + 1)^2.
+std::pair<big_integer, big_integer> fibonacci(uint32_t n) {
+    big_integer a = 0;
+    big_integer b = 1;
+    for (uint32_t bit = 1u << 31u; bit != 0; bit >>= 1u) {
+        if (a == 0 && (n & bit) == 0) {
+            continue;
+        }
+        big_integer sum = a + b;
+        big_integer a2 = a * a;
+        big_integer b2 = b * b;
+        big_integer even = sum * sum - a2 - a2 - b2;
+        big_integer odd = a2 + b2;
+        if (n & bit) {
+            a = odd;
+            b = even + odd;
+        } else {
+            a = even;
+            b = odd;
+        }
+    }
+    return {a, b};
+}
+
+std::pair<big_integer, big_integer> lucas(uint32_t n) {
+    std::pair<big_integer, big_integer> f = fibonacci(n);
+    return {(f.second << 1) - f.first, (f.first << 1) + f.second};
+}
+
+namespace {
+    uint32_t const PARALLEL_MIN_TERMS = 512;
+
+    // Evaluates sum over [begin, end) of a(k) * p(begin)...p(k) / (q(begin)...q(k))
+    // as t / q, splitting the range in halves so that the products at every level
+    // are between operands of similar length: with the halves (pl, ql, tl) and
+    // (pr, qr, tr), p = pl * pr, q = ql * qr and t = qr * tl + pl * tr. While
+    // more than one thread is left and the range is long enough, the left half
+    // runs as a separate task.
+    series_sum split_series(std::function<big_integer(uint32_t)> const &p,
+                            std::function<big_integer(uint32_t)> const &q,
+                            std::function<big_integer(uint32_t)> const &a,
+                            uint32_t begin, uint32_t end, size_t threads) {
+        if (end <= begin) {
+            return {1, 1, 0};
+        }
+        if (end - begin == 1) {
+            big_integer pk = p(begin);
+            return {pk, q(begin), a(begin) * pk};
+        }
+        uint32_t middle = begin + (end - begin) / 2;
+        series_sum left;
+        series_sum right;
+        if (threads > 1 && end - begin >= PARALLEL_MIN_TERMS) {
+            std::future<series_sum> left_task = std::async(std::launch::async, split_series, std::cref(p),
+                                                           std::cref(q), std::cref(a), begin, middle, threads / 2);
+            right = split_series(p, q, a, middle, end, threads - threads / 2);
+            left = left_task.get();
+        } else {
+            left = split_series(p, q, a, begin, middle, 1);
+            right = split_series(p, q, a, middle, end, 1);
+        }
+        return {left.p * right.p, left.q * right.q, right.q * left.t + left.p * right.t};
+    }
+}
+
+series_sum binary_splitting(std::function<big_integer(uint32_t)> const &p,
+                            std::function<big_integer(uint32_t)> const &q,
+                            std::function<big_integer(uint32_t)> const &a,
+                            uint32_t begin, uint32_t end) {
+    return split_series(p, q, a, begin, end, std::thread::hardware_concurrency());
+}
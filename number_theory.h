@@ -0,0 +1,88 @@
+#ifndef NUMBER_THEORY_H
+#define NUMBER_THEORY_H
+
+#include "big_integer.h"
+#include <functional>
+
+// Trial division by the primes below 1000, then Miller-Rabin on the first
+// 'rounds' prime bases and, unless disabled, a strong Lucas test; values below
+// 2^64 are decided exactly. Every call sets up a Montgomery context for n,
+// which costs about a tenth of one Miller-Rabin round, and next_prime and
+// prime_generator pay it again for each candidate that survives the sieve.
+// The default of one base together with the Lucas test is Baillie-PSW, which
+// has no known counterexample; it replaced an earlier default of ten bases.
+// For plain Miller-Rabin pass strong_lucas = false and the rounds wanted.
+bool is_probable_prime(big_integer const &n, int rounds = 1, bool strong_lucas = true);
+
+big_integer next_prime(big_integer const &n);
+
+bool lucas_lehmer(uint32_t p);
+
+big_integer gcd(big_integer first, big_integer second);
+
+big_integer mod_inverse(big_integer const &value, big_integer const &modulus);
+
+void batch_invert(std::vector<big_integer> &values, big_integer const &modulus);
+
+big_integer multi_powmod(std::vector<std::pair<big_integer, big_integer>> const &terms, big_integer const &modulus);
+
+std::vector<big_integer> batch_gcd(std::vector<big_integer> const &moduli);
+
+big_integer factorial(uint32_t n);
+
+big_integer binomial(uint32_t n, uint32_t k);
+
+big_integer multinomial(std::vector<uint32_t> const &ks);
+
+std::pair<big_integer, big_integer> fibonacci(uint32_t n);
+
+std::pair<big_integer, big_integer> lucas(uint32_t n);
+
+struct series_sum {
+    big_integer p;
+    big_integer q;
+    big_integer t;
+};
+
+// p, q and a may be called from several threads at once.
+series_sum binary_splitting(std::function<big_integer(uint32_t)> const &p,
+                            std::function<big_integer(uint32_t)> const &q,
+                            std::function<big_integer(uint32_t)> const &a,
+                            uint32_t begin, uint32_t end);
+
+class prime_generator {
+public:
+    explicit prime_generator(big_integer const &begin);
+
+    prime_generator(big_integer const &begin, big_integer const &end);
+
+    bool next(big_integer &prime);
+
+private:
+    big_integer base;
+    big_integer end;
+    bool bounded;
+    bool pending_two;
+    size_t position;
+    std::vector<uint32_t> remainders;
+    std::vector<bool> composite;
+
+    void sieve();
+};
+
+class crt_basis {
+public:
+    explicit crt_basis(std::vector<big_integer> const &moduli);
+
+    big_integer const &modulus() const;
+
+    size_t size() const;
+
+    big_integer reconstruct(std::vector<big_integer> const &residues) const;
+
+private:
+    std::vector<std::vector<big_integer>> tree;
+    std::vector<big_integer> inverses;
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <vector>
+
+// Levels of product and remainder trees whose nodes add up to fewer bits than
+// this are not worth the thread start-up.
+size_t const PARALLEL_MIN_BITS = 1u << 18u;
+
+// Calls body(i) for every i in [0, count), split into contiguous ranges over
+// the hardware threads when parallel is set. The calls must be independent;
+// an exception from any of them is rethrown once all ranges have finished.
+template<class Body>
+void parallel_for(size_t count, bool parallel, Body const &body) {
+    size_t threads = parallel ? std::min<size_t>(count, std::thread::hardware_concurrency()) : 1;
+    if (threads <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            body(i);
+        }
+        return;
+    }
+    std::vector<std::future<void>> tasks;
+    for (size_t t = 1; t < threads; t++) {
+        tasks.push_back(std::async(std::launch::async, [&body, count, threads, t]() {
+            for (size_t i = count * t / threads; i < count * (t + 1) / threads; i++) {
+                body(i);
+            }
+        }));
+    }
+    for (size_t i = 0; i < count / threads; i++) {
+        body(i);
+    }
+    for (auto &task : tasks) {
+        task.get();
+    }
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include "pseudo_mersenne.h"
+#include "digit_kernels.h"
+#include <stdexcept>
+
+pseudo_mersenne_context::pseudo_mersenne_context(uint32_t bits, uint32_t c) : bits(bits), c(c) {
+    if (bits < 2 || c == 0 || (bits <= 32 && c >= (1ull << (bits - 1)))) {
+        throw std::runtime_error("Pseudo-Mersenne modulus needs 0 < c < 2^(bits - 1)");
+    }
+    mod = (big_integer(1) << static_cast<int>(bits)) - big_integer::from_uint64(c);
+    mod_digits = big_integer_limbs::digits(mod);
+    mod_digits.resize((bits + 31) / 32);
+    unit = to_residue(1);
+}
+
+pseudo_mersenne_context::residue pseudo_mersenne_context::to_residue(big_integer const &value) const {
+    return reduced_digits(value);
+}
+
+big_integer pseudo_mersenne_context::from_residue(residue const &value) const {
+    return big_integer_limbs::from_digits(value);
+}
+
+// With x = high * 2^bits + low, x is congruent to low + c * high, which is
+// about bits - log2(c) bits shorter; a couple of folds leave a value below
+// 2^bits and at most one subtraction of the modulus finishes the reduction.
+// Each fold runs in place: digit i of the sum is written only after the high
+// digits at positions full + i and above that it still needs have been read.
+void pseudo_mersenne_context::reduce(residue &result, residue &value) const {
+    size_t n = size();
+    size_t full = bits / 32;
+    uint32_t partial = bits % 32;
+    uint32_t mask = partial == 0 ? 0 : (1u << partial) - 1;
+    for (;;) {
+        while (value.size() > n && value.back() == 0) {
+            value.pop_back();
+        }
+        if (value.size() < n) {
+            value.resize(n);
+        }
+        if (value.size() == n && (partial == 0 || (value[full] >> partial) == 0)) {
+            break;
+        }
+        size_t high_size = value.size() - full;
+        value.push_back(0);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < value.size(); i++) {
+            uint64_t high = 0;
+            if (i < high_size) {
+                high = value[full + i];
+                if (partial != 0) {
+                    high = (high >> partial) | static_cast<uint32_t>(value[full + i + 1] << (32 - partial));
+                }
+            }
+            uint32_t low = i < full ? value[i] : (i == full ? value[i] & mask : 0);
+            carry += low + high * c;
+            value[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+    }
+    if (!less_than_modulus(value.data(), 0)) {
+        subtract_modulus(value.data());
+    }
+    result.assign(value.begin(), value.begin() + n);
+}
+
+void pseudo_mersenne_context::multiply(residue &result, residue const &first, residue const &second,
+                                       residue &scratch) const {
+    scratch.reserve(2 * size() + 1);
+    scratch.resize(2 * size());
+    mul_digits(scratch.data(), first.data(), size(), second.data(), size());
+    reduce(result, scratch);
+}
+
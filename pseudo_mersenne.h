@@ -0,0 +1,25 @@
+#ifndef PSEUDO_MERSENNE_H
+#define PSEUDO_MERSENNE_H
+
+#include "residue_context.h"
+
+// Arithmetic modulo 2^bits - c for a small c, where reduction folds the bits
+// above position bits back in as c times their value instead of dividing.
+class pseudo_mersenne_context : public residue_context<pseudo_mersenne_context> {
+public:
+    pseudo_mersenne_context(uint32_t bits, uint32_t c);
+
+    residue to_residue(big_integer const &value) const;
+
+    big_integer from_residue(residue const &value) const;
+
+    void multiply(residue &result, residue const &first, residue const &second, residue &scratch) const;
+
+private:
+    uint32_t bits;
+    uint32_t c;
+
+    void reduce(residue &result, residue &value) const;
+};
+
+#endif
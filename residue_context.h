@@ -0,0 +1,119 @@
+#ifndef RESIDUE_CONTEXT_H
+#define RESIDUE_CONTEXT_H
+
+#include "big_integer_limbs.h"
+
+// The part of a reduction context that does not depend on how products are
+// reduced: residues are size() digits holding a value below the modulus, and
+// Context supplies multiply(result, first, second, scratch) for power().
+template<class Context>
+class residue_context {
+public:
+    typedef std::vector<uint32_t> residue;
+
+    big_integer const &modulus() const {
+        return mod;
+    }
+
+    size_t size() const {
+        return mod_digits.size();
+    }
+
+    residue const &one() const {
+        return unit;
+    }
+
+    void add(residue &result, residue const &first, residue const &second) const {
+        result.resize(size());
+        uint64_t carry = 0;
+        for (size_t i = 0; i < size(); i++) {
+            carry += static_cast<uint64_t>(first[i]) + second[i];
+            result[i] = static_cast<uint32_t>(carry);
+            carry >>= 32u;
+        }
+        if (!less_than_modulus(result.data(), static_cast<uint32_t>(carry))) {
+            subtract_modulus(result.data());
+        }
+    }
+
+    void sub(residue &result, residue const &first, residue const &second) const {
+        result.resize(size());
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < size(); i++) {
+            uint64_t diff = static_cast<uint64_t>(first[i]) - second[i] - borrow;
+            result[i] = static_cast<uint32_t>(diff);
+            borrow = diff >> 63u;
+        }
+        if (borrow != 0) {
+            uint64_t carry = 0;
+            for (size_t i = 0; i < size(); i++) {
+                carry += static_cast<uint64_t>(result[i]) + mod_digits[i];
+                result[i] = static_cast<uint32_t>(carry);
+                carry >>= 32u;
+            }
+        }
+    }
+
+    void power(residue &result, residue const &base, std::vector<uint32_t> const &exponent, residue &scratch) const {
+        Context const &context = static_cast<Context const &>(*this);
+        bool started = false;
+        for (size_t i = exponent.size(); i-- > 0;) {
+            for (uint32_t bit = 1u << 31u; bit != 0; bit >>= 1u) {
+                if (started) {
+                    context.multiply(result, result, result, scratch);
+                }
+                if (exponent[i] & bit) {
+                    if (started) {
+                        context.multiply(result, result, base, scratch);
+                    } else {
+                        result = base;
+                        started = true;
+                    }
+                }
+            }
+        }
+        if (!started) {
+            result = unit;
+        }
+    }
+
+protected:
+    big_integer mod;
+    std::vector<uint32_t> mod_digits;
+    residue unit;
+
+    // The digits of value reduced into [0, modulus), padded to size().
+    residue reduced_digits(big_integer const &value) const {
+        big_integer reduced = value % mod;
+        if (reduced < 0) {
+            reduced += mod;
+        }
+        residue result = big_integer_limbs::digits(reduced);
+        result.resize(size());
+        return result;
+    }
+
+    // Compares high * b^size() + value against the modulus.
+    bool less_than_modulus(uint32_t const *value, uint32_t high) const {
+        if (high != 0) {
+            return false;
+        }
+        for (size_t i = size(); i-- > 0;) {
+            if (value[i] != mod_digits[i]) {
+                return value[i] < mod_digits[i];
+            }
+        }
+        return false;
+    }
+
+    void subtract_modulus(uint32_t *value) const {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < size(); i++) {
+            uint64_t diff = static_cast<uint64_t>(value[i]) - mod_digits[i] - borrow;
+            value[i] = static_cast<uint32_t>(diff);
+            borrow = diff >> 63u;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,125 @@
+#include "rns_integer.h"
+#include <stdexcept>
+
+namespace {
+    // The largest primes below 2^31, so that a sum of two residues fits in a
+    // word and a product of two in a double word.
+    std::vector<uint32_t> choose_primes(size_t count) {
+        if (count == 0) {
+            throw std::runtime_error("RNS basis needs at least one prime");
+        }
+        std::vector<uint32_t> primes;
+        for (uint32_t candidate = (1u << 31u) - 1; primes.size() < count; candidate -= 2) {
+            if (candidate < 3) {
+                throw std::runtime_error("Too many RNS primes requested");
+            }
+            if (is_probable_prime(static_cast<int>(candidate))) {
+                primes.push_back(candidate);
+            }
+        }
+        return primes;
+    }
+
+    std::vector<big_integer> to_big_integers(std::vector<uint32_t> const &values) {
+        return std::vector<big_integer>(values.begin(), values.end());
+    }
+}
+
+rns_basis::rns_basis(size_t count) : primes(choose_primes(count)), crt(to_big_integers(primes)) {
+    for (uint32_t p : primes) {
+        divisors.emplace_back(p);
+    }
+}
+
+size_t rns_basis::size() const {
+    return primes.size();
+}
+
+uint32_t rns_basis::prime(size_t i) const {
+    return primes[i];
+}
+
+big_integer const &rns_basis::modulus() const {
+    return crt.modulus();
+}
+
+uint32_t rns_basis::reduce(uint64_t value, size_t i) const {
+    return static_cast<uint32_t>(divisors[i].remainder(0, value));
+}
+
+rns_integer::rns_integer(std::shared_ptr<rns_basis const> basis, big_integer const &value)
+        : basis(std::move(basis)) {
+    values.resize(this->basis->size());
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<uint32_t>(value.mod_u64(this->basis->divisors[i]));
+    }
+}
+
+// The result is the representative in (-M / 2, M / 2], so that values
+// whose magnitude stays below half the basis modulus round-trip with sign.
+big_integer rns_integer::to_big_integer() const {
+    std::vector<big_integer> residues(values.begin(), values.end());
+    big_integer result = basis->crt.reconstruct(residues);
+    if (result * 2 > basis->modulus()) {
+        result -= basis->modulus();
+    }
+    return result;
+}
+
+std::vector<uint32_t> const &rns_integer::residues() const {
+    return values;
+}
+
+void rns_integer::check_basis(rns_integer const &second) const {
+    if (basis != second.basis) {
+        throw std::runtime_error("RNS operands use different bases");
+    }
+}
+
+rns_integer rns_integer::operator-() const {
+    rns_integer result = *this;
+    for (size_t i = 0; i < values.size(); i++) {
+        result.values[i] = values[i] == 0 ? 0 : basis->primes[i] - values[i];
+    }
+    return result;
+}
+
+rns_integer &rns_integer::operator+=(rns_integer const &second) {
+    check_basis(second);
+    uint32_t const *primes = basis->primes.data();
+    for (size_t i = 0; i < values.size(); i++) {
+        uint32_t sum = values[i] + second.values[i];
+        values[i] = sum >= primes[i] ? sum - primes[i] : sum;
+    }
+    return *this;
+}
+
+rns_integer &rns_integer::operator-=(rns_integer const &second) {
+    check_basis(second);
+    uint32_t const *primes = basis->primes.data();
+    for (size_t i = 0; i < values.size(); i++) {
+        uint32_t difference = values[i] - second.values[i];
+        values[i] = values[i] < second.values[i] ? difference + primes[i] : difference;
+    }
+    return *this;
+}
+
+rns_integer &rns_integer::operator*=(rns_integer const &second) {
+    check_basis(second);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = basis->reduce(static_cast<uint64_t>(values[i]) * second.values[i], i);
+    }
+    return *this;
+}
+
+rns_integer operator+(rns_integer first, rns_integer const &second) {
+    return first += second;
+}
+
+rns_integer operator-(rns_integer first, rns_integer const &second) {
+    return first -= second;
+}
+
+rns_integer operator*(rns_integer first, rns_integer const &second) {
+    return first *= second;
+}
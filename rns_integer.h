@@ -0,0 +1,56 @@
+#ifndef RNS_INTEGER_H
+#define RNS_INTEGER_H
+
+#include "big_integer.h"
+#include "number_theory.h"
+
+class rns_basis {
+public:
+    explicit rns_basis(size_t count);
+
+    size_t size() const;
+
+    uint32_t prime(size_t i) const;
+
+    big_integer const &modulus() const;
+
+private:
+    std::vector<uint32_t> primes;
+    std::vector<word_divisor> divisors;
+    crt_basis crt;
+
+    uint32_t reduce(uint64_t value, size_t i) const;
+
+    friend class rns_integer;
+};
+
+class rns_integer {
+public:
+    rns_integer(std::shared_ptr<rns_basis const> basis, big_integer const &value);
+
+    big_integer to_big_integer() const;
+
+    std::vector<uint32_t> const &residues() const;
+
+    rns_integer operator-() const;
+
+    rns_integer &operator+=(rns_integer const &second);
+
+    rns_integer &operator-=(rns_integer const &second);
+
+    rns_integer &operator*=(rns_integer const &second);
+
+    friend rns_integer operator+(rns_integer first, rns_integer const &second);
+
+    friend rns_integer operator-(rns_integer first, rns_integer const &second);
+
+    friend rns_integer operator*(rns_integer first, rns_integer const &second);
+
+private:
+    std::shared_ptr<rns_basis const> basis;
+    std::vector<uint32_t> values;
+
+    void check_basis(rns_integer const &second) const;
+};
+
+#endif